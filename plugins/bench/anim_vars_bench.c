@@ -0,0 +1,169 @@
+// Benchmark of `set_anim_vars()` (see `plugins/gameplay/shared/anim_vars.inl`) on a crowd of 1k animated
+// characters. Each character holds its movement keys for a while and then picks new ones, as an AI driven
+// character would. Every frame, the variables of all characters are set either with `set_anim_vars()`,
+// which skips the ones that haven't changed, or by setting every variable, as the third-person sample used
+// to do for the player.
+//
+// The state machines are stand-ins whose `set_variable()` looks the variable up by name among the variables
+// of the state machine, as a real state machine has to. The benchmark reports the time per frame and the
+// number of `set_variable()` calls per frame for different rates of input changes.
+//
+//     anim_vars_bench [--characters N] [--frames N]
+
+static struct tm_animation_state_machine_api *tm_animation_state_machine_api;
+
+#include <foundation/allocator.h>
+#include <foundation/api_registry.h>
+#include <foundation/log.h>
+#include <foundation/macros.h>
+#include <foundation/murmurhash64a.inl>
+#include <foundation/os.h>
+
+#include <plugins/animation/animation_state_machine.h>
+#include <plugins/entity/entity.h>
+
+#include <foundation/math.inl>
+
+#include "../shared/bench_harness.inl"
+
+#include "../gameplay/shared/anim_vars.inl"
+#include "../gameplay/shared/random.inl"
+
+#define DEFAULT_CHARACTERS 1000
+#define DEFAULT_FRAMES 1000
+
+// Number of variables of the stand-in state machines. Besides the ones set by `set_anim_vars()`, a state
+// machine has variables used by its own blend trees.
+#define NUM_SM_VARIABLES 16
+
+struct tm_animation_state_machine_o
+{
+    tm_strhash_t names[NUM_SM_VARIABLES];
+    float values[NUM_SM_VARIABLES];
+    uint32_t num_variables;
+
+    // Incremented when a variable changes, so that the state machine knows to re-evaluate its transitions.
+    uint32_t version;
+};
+
+static uint64_t num_set_variable_calls;
+
+static void bench_asm__set_variable(tm_animation_state_machine_o *sm, tm_strhash_t name, float value)
+{
+    ++num_set_variable_calls;
+    for (uint32_t i = 0; i < sm->num_variables; ++i)
+    {
+        if (TM_STRHASH_U64(sm->names[i]) == TM_STRHASH_U64(name))
+        {
+            if (sm->values[i] != value)
+            {
+                sm->values[i] = value;
+                ++sm->version;
+            }
+            return;
+        }
+    }
+}
+
+static struct tm_animation_state_machine_api bench_asm_api = {
+    .set_variable = bench_asm__set_variable,
+};
+
+// The input variables come last, so that finding them takes as long as in a state machine with many
+// variables of its own.
+static void init_state_machine(tm_animation_state_machine_o *sm)
+{
+    *sm = (tm_animation_state_machine_o){.num_variables = NUM_SM_VARIABLES};
+    for (uint32_t i = 0; i < NUM_SM_VARIABLES - ANIM_VAR_COUNT; ++i)
+        sm->names[i] = TM_STRHASH(tm_murmur_hash_string("blend") + i);
+    for (uint32_t var = 0; var < ANIM_VAR_COUNT; ++var)
+        sm->names[NUM_SM_VARIABLES - ANIM_VAR_COUNT + var] = anim_var_names[var];
+}
+
+// Gives each character that is due new movement keys. A character keeps its keys for `hold_frames` frames on
+// average.
+static void update_input(float *values, uint32_t num_characters, uint32_t hold_frames, uint64_t *rng)
+{
+    for (uint32_t i = 0; i < num_characters; ++i)
+    {
+        if (next_random(rng) % hold_frames)
+            continue;
+
+        const uint64_t keys = next_random(rng);
+        float *v = values + i * ANIM_VAR_COUNT;
+        for (uint32_t var = 0; var < ANIM_VAR_COUNT; ++var)
+            v[var] = (float)((keys >> var) & 1);
+    }
+}
+
+static void set_all_vars(tm_animation_state_machine_o *const *sms, const float *values, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        for (uint32_t var = 0; var < ANIM_VAR_COUNT; ++var)
+            tm_animation_state_machine_api->set_variable(sms[i], anim_var_names[var], values[i * ANIM_VAR_COUNT + var]);
+    }
+}
+
+static void run(uint32_t num_characters, uint32_t num_frames, uint32_t hold_frames, bool use_cache, double *frame_ns)
+{
+    tm_animation_state_machine_o *state_machines = calloc(num_characters, sizeof(*state_machines));
+    tm_animation_state_machine_o **sms = calloc(num_characters, sizeof(*sms));
+    anim_vars_t *cache = calloc(num_characters, sizeof(*cache));
+    float *values = calloc(num_characters * ANIM_VAR_COUNT, sizeof(float));
+    for (uint32_t i = 0; i < num_characters; ++i)
+    {
+        init_state_machine(state_machines + i);
+        sms[i] = state_machines + i;
+    }
+
+    uint64_t rng = 1;
+    num_set_variable_calls = 0;
+    for (uint32_t frame = 0; frame < num_frames; ++frame)
+    {
+        update_input(values, num_characters, hold_frames, &rng);
+
+        const uint64_t t0 = bench_now_ns();
+        if (use_cache)
+            set_anim_vars(cache, sms, values, num_characters);
+        else
+            set_all_vars(sms, values, num_characters);
+        frame_ns[frame] = (double)(bench_now_ns() - t0);
+    }
+
+    bench_print_summary(use_cache ? "set_anim_vars()" : "set every frame", frame_ns, num_frames, "us");
+    printf(", %8.1f set_variable() calls/frame\n", (double)num_set_variable_calls / num_frames);
+
+    free(values);
+    free(cache);
+    free(sms);
+    free(state_machines);
+}
+
+int main(int argc, char **argv)
+{
+    tm_animation_state_machine_api = &bench_asm_api;
+
+    uint32_t num_characters = DEFAULT_CHARACTERS;
+    uint32_t num_frames = DEFAULT_FRAMES;
+
+    const bench_option_t options[] = {
+        {.name = "--characters", .value = &num_characters, .min = 1},
+        {.name = "--frames", .value = &num_frames, .min = 1},
+    };
+    if (!bench_parse_args(argc, argv, options, TM_ARRAY_COUNT(options)))
+        return 1;
+
+    // Input changes every frame, about twice a second and about every two seconds at 60 Hz.
+    static const uint32_t hold_frames[] = {1, 30, 120};
+
+    double *frame_ns = calloc(num_frames, sizeof(double));
+    for (uint32_t i = 0; i < TM_ARRAY_COUNT(hold_frames); ++i)
+    {
+        printf("%u characters, %u frames, input changes every %u frames:\n", num_characters, num_frames, hold_frames[i]);
+        run(num_characters, num_frames, hold_frames[i], false, frame_ns);
+        run(num_characters, num_frames, hold_frames[i], true, frame_ns);
+    }
+    free(frame_ns);
+    return 0;
+}
@@ -0,0 +1,193 @@
+// Micro-benchmark of `blackboard_cache_t` (see `plugins/shared/blackboard_cache.inl`). It simulates frames of
+// 50 engines that each read the time, the delta time and the camera from the blackboard, as the custom
+// component engine does. The values are read either by scanning the blackboard for every value or through a
+// cache per engine. It runs blackboards of different sizes, since scans get slower the further into the
+// blackboard the values are.
+//
+// With a stable blackboard, the cache only scans in the first frame. The "reordered" runs move the values
+// every frame, which is the worst case for the cache, as every read misses and scans.
+//
+//     blackboard_bench [--frames N] [--engines N]
+
+#include <foundation/allocator.h>
+#include <foundation/api_registry.h>
+#include <foundation/log.h>
+#include <foundation/macros.h>
+#include <foundation/murmurhash64a.inl>
+#include <foundation/os.h>
+
+#include <plugins/entity/entity.h>
+
+#include <foundation/math.inl>
+
+#include "../shared/bench_harness.inl"
+#include "../shared/blackboard_cache.inl"
+
+#define DEFAULT_FRAMES 10000
+#define DEFAULT_ENGINES 50
+
+// Frames are timed in batches of this many, since a single frame is too short for the clock.
+#define FRAMES_PER_SAMPLE 100
+
+static const uint32_t blackboard_sizes[] = {4, 16, 64};
+
+// Sum of the values read, so that the reads can't be optimized away.
+static volatile double sink;
+
+enum
+{
+    BB__TIME,
+    BB__DELTA_TIME,
+    BB__CAMERA_TRANSFORM,
+    BB__COUNT,
+};
+
+static const tm_strhash_t keys[BB__COUNT] = {
+    [BB__TIME] = TM_ENTITY_BB__TIME,
+    [BB__DELTA_TIME] = TM_ENTITY_BB__DELTA_TIME,
+    [BB__CAMERA_TRANSFORM] = TM_ENTITY_BB__CAMERA_TRANSFORM,
+};
+
+// What engines read before `blackboard_cache_t`: a scan of the blackboard for every value.
+static const tm_entity_blackboard_value_t *scan(const tm_engine_update_set_t *data, tm_strhash_t key)
+{
+    for (const tm_entity_blackboard_value_t *bb = data->blackboard_start; bb != data->blackboard_end; ++bb)
+    {
+        if (TM_STRHASH_U64(bb->id) == TM_STRHASH_U64(key))
+            return bb;
+    }
+    return 0;
+}
+
+// Fills `bb` with `n` values. The values the engines read are spread out over the blackboard, and moved by
+// `rotation` slots.
+static void fill_blackboard(tm_entity_blackboard_value_t *bb, uint32_t n, uint32_t rotation, const tm_transform_t *camera)
+{
+    for (uint32_t i = 0; i < n; ++i)
+        bb[i] = (tm_entity_blackboard_value_t){.id = TM_STRHASH(tm_murmur_hash_string("bench_value") + i)};
+
+    for (uint32_t k = 0; k < BB__COUNT; ++k)
+    {
+        const uint32_t slot = ((k + 1) * n / (BB__COUNT + 1) + rotation) % n;
+        bb[slot].id = keys[k];
+    }
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (TM_STRHASH_U64(bb[i].id) == TM_STRHASH_U64(keys[BB__CAMERA_TRANSFORM]))
+            bb[i].ptr_value = (void *)camera;
+        else
+            bb[i].double_value = (double)i;
+    }
+}
+
+typedef struct run_t
+{
+    uint32_t num_values;
+    uint32_t num_engines;
+    uint32_t num_frames;
+    bool use_cache;
+    bool reorder;
+    TM_PAD(2);
+} run_t;
+
+// Returns the sum of the values read.
+static double run(const run_t *r, double *sample_ns, uint32_t *num_scans)
+{
+    tm_entity_blackboard_value_t *bb = calloc(r->num_values, sizeof(*bb));
+    blackboard_cache_t *caches = calloc(r->num_engines, sizeof(*caches));
+    for (uint32_t e = 0; e < r->num_engines; ++e)
+        blackboard_cache_init(caches + e, keys, BB__COUNT);
+
+    const tm_transform_t camera = {.rot = {0, 0, 0, 1}, .scl = {1, 1, 1}};
+    fill_blackboard(bb, r->num_values, 0, &camera);
+    tm_engine_update_set_t set = {
+        .blackboard_start = bb,
+        .blackboard_end = bb + r->num_values,
+    };
+
+    double sum = 0;
+    const uint32_t num_samples = r->num_frames / FRAMES_PER_SAMPLE;
+    for (uint32_t s = 0; s < num_samples; ++s)
+    {
+        uint64_t ns = 0;
+        for (uint32_t f = 0; f < FRAMES_PER_SAMPLE; ++f)
+        {
+            if (r->reorder)
+                fill_blackboard(bb, r->num_values, s * FRAMES_PER_SAMPLE + f, &camera);
+
+            const uint64_t t0 = bench_now_ns();
+            for (uint32_t e = 0; e < r->num_engines; ++e)
+            {
+                if (r->use_cache)
+                {
+                    sum += blackboard_cache_double(caches + e, &set, BB__TIME, 0);
+                    sum += blackboard_cache_double(caches + e, &set, BB__DELTA_TIME, 0);
+                    sum += blackboard_cache_ptr(caches + e, &set, BB__CAMERA_TRANSFORM) ? 1 : 0;
+                }
+                else
+                {
+                    const tm_entity_blackboard_value_t *t = scan(&set, keys[BB__TIME]);
+                    const tm_entity_blackboard_value_t *dt = scan(&set, keys[BB__DELTA_TIME]);
+                    const tm_entity_blackboard_value_t *cam = scan(&set, keys[BB__CAMERA_TRANSFORM]);
+                    sum += (t ? t->double_value : 0) + (dt ? dt->double_value : 0) + (cam && cam->ptr_value ? 1 : 0);
+                }
+            }
+            ns += bench_now_ns() - t0;
+        }
+        sample_ns[s] = (double)ns / FRAMES_PER_SAMPLE;
+    }
+
+    *num_scans = 0;
+    for (uint32_t e = 0; e < r->num_engines; ++e)
+        *num_scans += caches[e].num_scans;
+
+    free(caches);
+    free(bb);
+    return sum;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t num_frames = DEFAULT_FRAMES;
+    uint32_t num_engines = DEFAULT_ENGINES;
+
+    const bench_option_t options[] = {
+        {.name = "--frames", .value = &num_frames, .min = FRAMES_PER_SAMPLE},
+        {.name = "--engines", .value = &num_engines, .min = 1},
+    };
+    if (!bench_parse_args(argc, argv, options, TM_ARRAY_COUNT(options)))
+        return 1;
+
+    double *sample_ns = calloc(num_frames / FRAMES_PER_SAMPLE, sizeof(double));
+
+    printf("%u engines reading %u values, %u frames:\n", num_engines, BB__COUNT, num_frames);
+    for (uint32_t i = 0; i < TM_ARRAY_COUNT(blackboard_sizes); ++i)
+    {
+        for (uint32_t reorder = 0; reorder < 2; ++reorder)
+        {
+            for (uint32_t use_cache = 0; use_cache < 2; ++use_cache)
+            {
+                const run_t r = {
+                    .num_values = blackboard_sizes[i],
+                    .num_engines = num_engines,
+                    .num_frames = num_frames,
+                    .use_cache = use_cache,
+                    .reorder = reorder,
+                };
+                uint32_t num_scans;
+                sink += run(&r, sample_ns, &num_scans);
+
+                char label[64];
+                snprintf(label, sizeof(label), "%u values%s, %s", r.num_values, reorder ? ", reordered" : "", use_cache ? "cache" : "scan");
+                const bench_summary_t s = bench_print_summary(label, sample_ns, num_frames / FRAMES_PER_SAMPLE, "ns");
+                printf(", %6.2f ns/read", s.median / (num_engines * BB__COUNT));
+                if (use_cache)
+                    printf(", %u scans", num_scans);
+                printf("\n");
+            }
+        }
+    }
+
+    free(sample_ns);
+    return 0;
+}
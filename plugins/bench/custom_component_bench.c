@@ -0,0 +1,199 @@
+// Benchmark of the custom component engine on a growing number of worker threads. It creates entities with
+// a custom component and a transform in a stand-in entity context (see `plugins/shared/bench_harness.inl`),
+// runs the engine on them with the stand-in job system of `plugins/shared/bench_job_system.inl` and reports
+// the time per frame for each thread count, along with the speedup over one thread.
+//
+//     custom_component_bench [--entities N] [--frames N] [--threads N] [--motion M] [--camera] [--csv]
+//
+// `M` is `bob`, `rotate`, `orbit`, `ping_pong` or `mixed`, which gives the entities every motion in turn.
+// With `--camera`, the entities have LOD enabled and the blackboard has a camera in the middle of them, so
+// distant entities are updated less often or not at all. Without `--threads`, the engine is run on 1, 2, 4, 8 and 16 threads.
+
+#include <foundation/allocator.h>
+#include <foundation/api_registry.h>
+#include <foundation/job_system.h>
+#include <foundation/log.h>
+#include <foundation/macros.h>
+#include <foundation/murmurhash64a.inl>
+#include <foundation/os.h>
+
+#include <plugins/entity/entity.h>
+#include <plugins/entity/transform_component.h>
+
+#include <foundation/math.inl>
+
+#include "../shared/bench_harness.inl"
+#include "../shared/bench_job_system.inl"
+
+#include "../custom_component/custom_component.c"
+
+#include <unistd.h>
+
+#define DEFAULT_ENTITIES 1000000
+#define DEFAULT_FRAMES 100
+#define FRAME_DT (1.0 / 60.0)
+
+// Entities are laid out on a grid in the XZ plane with this spacing.
+#define SPACING 1.0f
+
+// Motion given to every entity, or `MOTION_MIXED`.
+#define MOTION_MIXED CUSTOM_MOTION__COUNT
+
+static const char *motion_names[] = {
+    [CUSTOM_MOTION__BOB] = "bob",
+    [CUSTOM_MOTION__ROTATE] = "rotate",
+    [CUSTOM_MOTION__ORBIT] = "orbit",
+    [CUSTOM_MOTION__PING_PONG] = "ping_pong",
+    [MOTION_MIXED] = "mixed",
+};
+
+static const uint32_t default_threads[] = {1, 2, 4, 8, 16};
+
+typedef struct scene_t
+{
+    tm_entity_context_o *ctx;
+    const tm_engine_i *engine;
+    tm_entity_t first;
+    uint32_t num_entities;
+    TM_PAD(4);
+} scene_t;
+
+static scene_t create_scene(uint32_t num_entities, uint32_t motion, bool lod)
+{
+    tm_entity_context_o *ctx = bench_entity_context_create(num_entities);
+    const tm_component_type_t transform_type = bench_entity_register_plain_component(ctx, TM_TT_TYPE__TRANSFORM_COMPONENT, sizeof(tm_transform_component_t));
+    component__create(ctx);
+    const tm_component_type_t custom_type = bench_entity__lookup_component_type(ctx, TM_TT_TYPE_HASH__CUSTOM_COMPONENT);
+
+    scene_t scene = {
+        .ctx = ctx,
+        .num_entities = num_entities,
+    };
+
+    const uint32_t side = (uint32_t)ceil(sqrt((double)num_entities));
+    for (uint32_t i = 0; i < num_entities; ++i)
+    {
+        const tm_entity_t e = bench_entity_create(ctx);
+        if (!i)
+            scene.first = e;
+
+        tm_transform_component_t *t = bench_entity_add_component(ctx, e, transform_type);
+        t->world.pos = (tm_vec3_t){(float)(i % side) * SPACING, 0, (float)(i / side) * SPACING};
+        t->world.rot = (tm_vec4_t){0, 0, 0, 1};
+        t->world.scl = (tm_vec3_t){1, 1, 1};
+
+        struct tm_custom_component_t *c = bench_entity_add_component(ctx, e, custom_type);
+        *c = (struct tm_custom_component_t){
+            .motion = motion == MOTION_MIXED ? i % CUSTOM_MOTION__COUNT : motion,
+            .frequency = 1.0f + (float)(i % 7) * 0.25f,
+            .amplitude = 1.0f,
+            .lod = lod,
+        };
+    }
+
+    component__register_engine(ctx);
+    scene.engine = ctx->engines;
+    return scene;
+}
+
+static void run_threads(scene_t *scene, tm_engine_update_set_t *set, tm_entity_blackboard_value_t *blackboard, uint32_t num_threads, uint32_t num_frames, double *frame_ns, double *t)
+{
+    bench_job_system_init(num_threads);
+
+    // One frame to warm up the caches and, on the first run, capture the starting poses.
+    blackboard[0].double_value = *t;
+    scene->engine->update(scene->engine->inst, set, 0);
+
+    for (uint32_t frame = 0; frame < num_frames; ++frame)
+    {
+        *t += FRAME_DT;
+        blackboard[0].double_value = *t;
+
+        const uint64_t t0 = bench_now_ns();
+        scene->engine->update(scene->engine->inst, set, 0);
+        frame_ns[frame] = (double)(bench_now_ns() - t0);
+    }
+
+    bench_job_system_shutdown();
+}
+
+int main(int argc, char **argv)
+{
+    tm_entity_api = bench_entity_api();
+    tm_job_system_api = bench_job_system_api();
+
+    uint32_t num_entities = DEFAULT_ENTITIES;
+    uint32_t num_frames = DEFAULT_FRAMES;
+    uint32_t threads = 0;
+    uint32_t motion = MOTION_MIXED;
+    bool camera = false;
+    bool csv = false;
+
+    const bench_option_t options[] = {
+        {.name = "--entities", .value = &num_entities, .min = 1},
+        {.name = "--frames", .value = &num_frames, .min = 1},
+        {.name = "--threads", .value = &threads, .min = 1},
+        {.name = "--motion", .value = &motion, .choices = motion_names, .num_choices = TM_ARRAY_COUNT(motion_names)},
+        {.name = "--camera", .flag = &camera},
+        {.name = "--csv", .flag = &csv},
+    };
+    if (!bench_parse_args(argc, argv, options, TM_ARRAY_COUNT(options)))
+        return 1;
+
+    scene_t scene = create_scene(num_entities, motion, camera);
+
+    const uint32_t side = (uint32_t)ceil(sqrt((double)num_entities));
+    const tm_transform_t camera_transform = {
+        .pos = {(float)side * SPACING / 2, 2, (float)side * SPACING / 2},
+        .rot = {0, 0, 0, 1},
+        .scl = {1, 1, 1},
+    };
+    tm_entity_blackboard_value_t blackboard[3] = {
+        {.id = TM_ENTITY_BB__TIME},
+        {.id = TM_ENTITY_BB__DELTA_TIME, .double_value = FRAME_DT},
+        {.id = TM_ENTITY_BB__CAMERA_TRANSFORM, .ptr_value = (void *)&camera_transform},
+    };
+    tm_engine_update_set_t *set = bench_engine_update_set(scene.ctx, scene.engine, scene.first, num_entities, blackboard, camera ? 3 : 2);
+
+    const uint32_t *thread_counts = threads ? &threads : default_threads;
+    const uint32_t num_thread_counts = threads ? 1 : TM_ARRAY_COUNT(default_threads);
+    double *frame_ns = calloc(num_frames, sizeof(double));
+    double t = 0;
+    double single_thread_ms = 0;
+
+    if (csv)
+        printf("entities,motion,camera,threads,frame,update_ns\n");
+    else
+        printf("%u entities (%s%s), %u frames, %ld hardware threads:\n", num_entities, motion_names[motion], camera ? ", camera" : "", num_frames, sysconf(_SC_NPROCESSORS_ONLN));
+
+    for (uint32_t i = 0; i < num_thread_counts; ++i)
+    {
+        const uint32_t num_threads = tm_min(tm_max(thread_counts[i], 1u), BENCH_MAX_THREADS);
+        run_threads(&scene, set, blackboard, num_threads, num_frames, frame_ns, &t);
+
+        if (csv)
+        {
+            for (uint32_t frame = 0; frame < num_frames; ++frame)
+                printf("%u,%s,%u,%u,%u,%.0f\n", num_entities, motion_names[motion], camera, num_threads, frame, frame_ns[frame]);
+            continue;
+        }
+
+        char label[32];
+        snprintf(label, sizeof(label), "%u thread%s", num_threads, num_threads == 1 ? "" : "s");
+        const bench_summary_t s = bench_print_summary(label, frame_ns, num_frames, "ms");
+        const double median_ms = s.median * 1e-6;
+        if (!i)
+            single_thread_ms = num_threads == 1 ? median_ms : 0;
+        if (single_thread_ms)
+            printf(", %5.2fx speedup", single_thread_ms / median_ms);
+        printf(", %7.1f M entities/s\n", num_entities / (s.median * 1e-9) * 1e-6);
+    }
+
+    if (!csv)
+        printf("    %.1f notify() calls and %.0f notified entities per frame\n", (double)scene.ctx->num_notify_calls / (num_thread_counts * (num_frames + 1)), (double)scene.ctx->num_notified / (num_thread_counts * (num_frames + 1)));
+
+    free(frame_ns);
+    bench_engine_update_set_free(set);
+    bench_entity_context_destroy(scene.ctx);
+    return 0;
+}
@@ -0,0 +1,193 @@
+// Micro-benchmark of `input_state_update()` (see `plugins/gameplay/shared/input_state.inl`) at 10k input
+// events per frame, far more than a player makes, as a bound on what the shared input code can cost.
+//
+// The events come from a stand-in for `tm_input_api` that keeps the events of the current frame in a ring,
+// like the real input system, and copies them out in `events()`. Most events are mouse moves, the rest are
+// key and mouse button changes. The benchmark times:
+//
+// * `input_state_update()` with the mouse captured and not captured. This includes copying the events out
+//   of the ring in batches of `INPUT_EVENT_BATCH`.
+// * `input_state_apply_event()` on the events in the ring, without the copy, to tell the cost of the copy
+//   apart from the cost of applying the events.
+//
+//     input_state_bench [--events N] [--frames N]
+
+static struct tm_input_api *tm_input_api;
+
+#include <foundation/allocator.h>
+#include <foundation/api_registry.h>
+#include <foundation/input.h>
+#include <foundation/log.h>
+#include <foundation/macros.h>
+#include <foundation/os.h>
+
+#include <foundation/math.inl>
+
+#include "../shared/bench_harness.inl"
+
+#include "../gameplay/shared/input_state.inl"
+#include "../gameplay/shared/random.inl"
+
+#define DEFAULT_EVENTS 10000
+#define DEFAULT_FRAMES 1000
+
+// Stand-in for the input system. Holds the events of the current frame.
+typedef struct bench_input_t
+{
+    tm_input_event_t *ring;
+    uint64_t ring_size;
+
+    // Number of events sent so far. The events of the current frame are the last `ring_size` ones.
+    uint64_t num_events;
+
+    tm_input_source_i keyboard;
+    tm_input_source_i mouse;
+} bench_input_t;
+
+static bench_input_t bench_input;
+
+static uint64_t bench_input__events(uint64_t start, tm_input_event_t *events, uint64_t buffer_size)
+{
+    const uint64_t n = start < bench_input.num_events ? tm_min(bench_input.num_events - start, buffer_size) : 0;
+    for (uint64_t i = 0; i < n; ++i)
+        events[i] = bench_input.ring[(start + i) % bench_input.ring_size];
+    return n;
+}
+
+static struct tm_input_api bench_input_api = {
+    .events = bench_input__events,
+};
+
+// Keys pressed and released by the generated events: the movement keys of the samples and a few others.
+static const uint32_t event_keys[] = {
+    TM_INPUT_KEYBOARD_ITEM_W,
+    TM_INPUT_KEYBOARD_ITEM_A,
+    TM_INPUT_KEYBOARD_ITEM_S,
+    TM_INPUT_KEYBOARD_ITEM_D,
+    TM_INPUT_KEYBOARD_ITEM_SPACE,
+    TM_INPUT_KEYBOARD_ITEM_LEFTSHIFT,
+    TM_INPUT_KEYBOARD_ITEM_ESCAPE,
+};
+
+// Sends a frame of `ring_size` events: 80 % mouse moves, 15 % key changes and 5 % left mouse button changes.
+static void send_events(uint64_t *rng)
+{
+    for (uint64_t i = 0; i < bench_input.ring_size; ++i)
+    {
+        const uint64_t r = next_random(rng);
+        const uint32_t kind = (uint32_t)(r % 100);
+        const float down = (float)((r >> 32) & 1);
+
+        tm_input_event_t *e = bench_input.ring + (bench_input.num_events + i) % bench_input.ring_size;
+        if (kind < 80)
+        {
+            *e = (tm_input_event_t){
+                .source = &bench_input.mouse,
+                .item_id = TM_INPUT_MOUSE_ITEM_MOVE,
+                .type = TM_INPUT_EVENT_TYPE_DATA_CHANGE,
+                .data.f = {(float)((r >> 8) & 15) - 7.5f, (float)((r >> 12) & 15) - 7.5f},
+            };
+        }
+        else if (kind < 95)
+        {
+            *e = (tm_input_event_t){
+                .source = &bench_input.keyboard,
+                .item_id = event_keys[(r >> 16) % TM_ARRAY_COUNT(event_keys)],
+                .type = TM_INPUT_EVENT_TYPE_DATA_CHANGE,
+                .data.f = {down},
+            };
+        }
+        else
+        {
+            *e = (tm_input_event_t){
+                .source = &bench_input.mouse,
+                .item_id = TM_INPUT_MOUSE_ITEM_BUTTON_LEFT,
+                .type = TM_INPUT_EVENT_TYPE_DATA_CHANGE,
+                .data.f = {down},
+            };
+        }
+    }
+    bench_input.num_events += bench_input.ring_size;
+}
+
+// Applies the events of the current frame in place, without copying them.
+static void apply_events_in_place(input_state_t *in, bool captured)
+{
+    input_state_begin_frame(in);
+    for (; in->processed_events < bench_input.num_events; ++in->processed_events)
+        input_state_apply_event(in, bench_input.ring + in->processed_events % bench_input.ring_size, captured);
+}
+
+enum run_kind
+{
+    RUN__UPDATE_CAPTURED,
+    RUN__UPDATE_NOT_CAPTURED,
+    RUN__APPLY_IN_PLACE,
+    RUN__COUNT,
+};
+
+static const char *const run_labels[RUN__COUNT] = {
+    [RUN__UPDATE_CAPTURED] = "update, captured",
+    [RUN__UPDATE_NOT_CAPTURED] = "update, not captured",
+    [RUN__APPLY_IN_PLACE] = "apply in place, captured",
+};
+
+// Mouse movement and keys read back, so that the updates can't be optimized away.
+static volatile float sink;
+
+static void run(enum run_kind kind, uint32_t num_frames, double *frame_ns)
+{
+    input_state_t in = {.processed_events = bench_input.num_events};
+    uint64_t rng = 1;
+
+    static const uint32_t movement_keys[] = {TM_INPUT_KEYBOARD_ITEM_W, TM_INPUT_KEYBOARD_ITEM_A, TM_INPUT_KEYBOARD_ITEM_S, TM_INPUT_KEYBOARD_ITEM_D};
+
+    for (uint32_t frame = 0; frame < num_frames; ++frame)
+    {
+        send_events(&rng);
+
+        const uint64_t t0 = bench_now_ns();
+        if (kind == RUN__APPLY_IN_PLACE)
+            apply_events_in_place(&in, true);
+        else
+            input_state_update(&in, kind == RUN__UPDATE_CAPTURED);
+        const uint32_t actions = input_actions_held(&in, movement_keys, TM_ARRAY_COUNT(movement_keys));
+        frame_ns[frame] = (double)(bench_now_ns() - t0);
+
+        sink += in.mouse_delta.x + in.mouse_delta.y + (float)actions;
+    }
+
+    const bench_summary_t s = bench_print_summary(run_labels[kind], frame_ns, num_frames, "us");
+    printf(", %5.2f ns/event\n", s.median / bench_input.ring_size);
+}
+
+int main(int argc, char **argv)
+{
+    tm_input_api = &bench_input_api;
+
+    uint32_t num_events = DEFAULT_EVENTS;
+    uint32_t num_frames = DEFAULT_FRAMES;
+
+    const bench_option_t options[] = {
+        {.name = "--events", .value = &num_events, .min = 1},
+        {.name = "--frames", .value = &num_frames, .min = 1},
+    };
+    if (!bench_parse_args(argc, argv, options, TM_ARRAY_COUNT(options)))
+        return 1;
+
+    bench_input = (bench_input_t){
+        .ring = calloc(num_events, sizeof(tm_input_event_t)),
+        .ring_size = num_events,
+        .keyboard = {.controller_type = TM_INPUT_CONTROLLER_TYPE_KEYBOARD},
+        .mouse = {.controller_type = TM_INPUT_CONTROLLER_TYPE_MOUSE},
+    };
+
+    double *frame_ns = calloc(num_frames, sizeof(double));
+    printf("%u events/frame, %u frames, batches of %u events:\n", num_events, num_frames, INPUT_EVENT_BATCH);
+    for (uint32_t kind = 0; kind < RUN__COUNT; ++kind)
+        run(kind, num_frames, frame_ns);
+
+    free(frame_ns);
+    free(bench_input.ring);
+    return 0;
+}
@@ -0,0 +1,739 @@
+// Headless benchmark of the interaction system. It builds synthetic levels of levers that open doors in a
+// stand-in entity context (see `plugins/shared/bench_harness.inl`), then plays them: every frame some
+// levers are pulled through `can_interact()` and `interact()`, and the interactable engine is updated.
+//
+// For each level it reports the time per frame spent pulling levers and updating the engine, the
+// allocations made and the number of active and queued interactions. With `--csv`, it prints one line per
+// frame instead.
+//
+//     interaction_system_bench [--frames N] [--levers N --doors N] [--chain N] [--csv]
+//
+// Without `--levers`, a series of levels of increasing size is run. The benchmark fails if the interaction
+// system allocates after the first frame of a level, since it reserves everything it needs up front.
+//
+// It then times spawning: `component__asset_loaded()` is run for `--spawns` instances of a lever, a button
+// and a door asset, which are read from a stand-in for The Truth. The spawns are timed with the descriptor
+// cache and with the cache cleared before every spawn, which is what loading cost before the cache. Along
+// with the time, it reports the number of calls made to The Truth per spawn.
+//
+//     interaction_system_bench [--spawns N] [--spawn-runs N]
+//
+// Last, it compares the check of whether an interactable is already active, which `can_interact()` makes
+// for every link of a target chain: a lookup in `active_lookup` against a scan of the active interactions,
+// which is how the check was made before `active_lookup`. `--active` interactables are made active and as
+// many other interactables are looked up as well, so half of the lookups miss.
+//
+//     interaction_system_bench [--active N]
+
+#include <foundation/allocator.h>
+#include <foundation/api_registry.h>
+#include <foundation/log.h>
+#include <foundation/macros.h>
+#include <foundation/murmurhash64a.inl>
+#include <foundation/os.h>
+
+#include <plugins/entity/entity.h>
+#include <plugins/entity/transform_component.h>
+
+#include <foundation/math.inl>
+
+#include "../shared/bench_harness.inl"
+
+// The interactable engine animates lever handles and door pivots through these. Since the stand-in
+// entities have no parents, setting the local transform sets the world transform.
+
+struct tm_transform_component_manager_o
+{
+    tm_entity_context_o *ctx;
+    tm_component_type_t type;
+};
+
+static tm_transform_component_t *bench_transform(tm_transform_component_manager_o *man, tm_entity_t e)
+{
+    return bench_entity__write_component(man->ctx, e, man->type);
+}
+
+static tm_vec3_t bench_get_local_position(tm_transform_component_manager_o *man, tm_entity_t e)
+{
+    return bench_transform(man, e)->world.pos;
+}
+
+static tm_vec4_t bench_get_local_rotation(tm_transform_component_manager_o *man, tm_entity_t e)
+{
+    return bench_transform(man, e)->world.rot;
+}
+
+static void bench_set_local_position(tm_transform_component_manager_o *man, tm_entity_t e, tm_vec3_t pos)
+{
+    tm_transform_component_t *t = bench_transform(man, e);
+    t->world.pos = pos;
+    ++t->version;
+}
+
+static void bench_set_local_rotation(tm_transform_component_manager_o *man, tm_entity_t e, tm_vec4_t rot)
+{
+    tm_transform_component_t *t = bench_transform(man, e);
+    t->world.rot = rot;
+    ++t->version;
+}
+
+#undef tm_get_local_position
+#define tm_get_local_position bench_get_local_position
+#undef tm_get_local_rotation
+#define tm_get_local_rotation bench_get_local_rotation
+#undef tm_set_local_position
+#define tm_set_local_position bench_set_local_position
+#undef tm_set_local_rotation
+#define tm_set_local_rotation bench_set_local_rotation
+
+#include "../gameplay/interaction_system/interactable_component.c"
+
+#include "../gameplay/shared/random.inl"
+
+#define DEFAULT_FRAMES 600
+#define DEFAULT_SPAWNS 10000
+#define DEFAULT_SPAWN_RUNS 20
+#define DEFAULT_ACTIVE 10000
+
+// Lookups of the active interactions are timed in batches of this many.
+#define ACTIVE_LOOKUP_SAMPLES 100
+#define FRAME_DT (1.0 / 60.0)
+
+// Distance between interactables in the level, more than the reach of a player so that `find_interactable()`
+// style queries don't see several of them at once.
+#define SPACING 4.0f
+
+typedef struct level_desc_t
+{
+    uint32_t num_levers;
+    uint32_t num_doors;
+
+    // Doors are chained in runs of this many: each door of a run opens the next one when it has opened.
+    // Levers open the first door of a run.
+    uint32_t chain_length;
+    TM_PAD(4);
+} level_desc_t;
+
+static const level_desc_t default_levels[] = {
+    {100, 50, 2},
+    {1000, 500, 2},
+    {10000, 5000, 2},
+    {100000, 50000, 2},
+};
+
+typedef struct level_t
+{
+    tm_entity_context_o *ctx;
+    tm_interactable_component_manager_o *mgr;
+    const tm_engine_i *engine;
+
+    // Interactables are created first, levers then doors, so they make up a single update array.
+    tm_entity_t first_interactable;
+    uint32_t num_interactables;
+    uint32_t num_levers;
+} level_t;
+
+static tm_vec3_t grid_position(uint32_t i, uint32_t n)
+{
+    const uint32_t side = (uint32_t)ceil(sqrt((double)n));
+    return (tm_vec3_t){(float)(i % side) * SPACING, 0, (float)(i / side) * SPACING};
+}
+
+static level_t create_level(const level_desc_t *desc)
+{
+    const uint32_t num_interactables = desc->num_levers + desc->num_doors;
+    tm_entity_context_o *ctx = bench_entity_context_create(2 * num_interactables);
+
+    const tm_component_type_t transform_type = bench_entity_register_plain_component(ctx, TM_TT_TYPE__TRANSFORM_COMPONENT, sizeof(tm_transform_component_t));
+    struct tm_transform_component_manager_o *trans_mgr = calloc(1, sizeof(*trans_mgr));
+    *trans_mgr = (struct tm_transform_component_manager_o){.ctx = ctx, .type = transform_type};
+    ctx->types[transform_type.index].i.manager = (tm_component_manager_o *)trans_mgr;
+
+    component__create(ctx);
+    const tm_component_type_t interactable_type = bench_entity__lookup_component_type(ctx, TM_TT_TYPE_HASH__INTERACTABLE_COMPONENT);
+
+    level_t level = {
+        .ctx = ctx,
+        .num_interactables = num_interactables,
+        .num_levers = desc->num_levers,
+    };
+
+    // Interactables first, then the handles and pivots they animate.
+    for (uint32_t i = 0; i < num_interactables; ++i)
+    {
+        const tm_entity_t e = bench_entity_create(ctx);
+        if (!i)
+            level.first_interactable = e;
+        tm_transform_component_t *t = bench_entity_add_component(ctx, e, transform_type);
+        t->world.pos = grid_position(i, num_interactables);
+        t->world.rot = (tm_vec4_t){0, 0, 0, 1};
+        t->world.scl = (tm_vec3_t){1, 1, 1};
+        t->version = 1;
+        bench_entity_add_component(ctx, e, interactable_type);
+    }
+
+    const tm_vec4_t closed = {0, 0, 0, 1};
+    const uint32_t chain_length = tm_max(desc->chain_length, 1u);
+    const uint32_t num_chains = tm_max((desc->num_doors + chain_length - 1) / chain_length, 1u);
+
+    for (uint32_t i = 0; i < num_interactables; ++i)
+    {
+        const tm_entity_t e = {.u64 = level.first_interactable.u64 + i};
+        const tm_entity_t part = bench_entity_create(ctx);
+        tm_transform_component_t *t = bench_entity_add_component(ctx, part, transform_type);
+        t->world.rot = closed;
+        t->world.scl = (tm_vec3_t){1, 1, 1};
+
+        interactable_component_t *c = bench_entity__write_component(ctx, e, interactable_type);
+        if (i < desc->num_levers)
+        {
+            const uint32_t door = (i % num_chains) * chain_length;
+            *c = (interactable_component_t){
+                .type = INTERACTABLE_TYPE_LEVER,
+                .target_activation_delay = 0.25f,
+                .target = door < desc->num_doors ? (tm_entity_t){.u64 = level.first_interactable.u64 + desc->num_levers + door} : (tm_entity_t){0},
+                .player_can_activate = true,
+                .lever = {
+                    .handle = part,
+                    .handle_closed_rotation = closed,
+                    .handle_open_rotation = tm_quaternion_from_rotation((tm_vec3_t){1, 0, 0}, 1.0f),
+                    .handle_open_time = 0.5f,
+                },
+            };
+        }
+        else
+        {
+            const uint32_t door = i - desc->num_levers;
+            const bool last_in_chain = (door + 1) % chain_length == 0 || door + 1 == desc->num_doors;
+            *c = (interactable_component_t){
+                .type = INTERACTABLE_TYPE_ROTATING_DOOR,
+                .target_activation_delay = 0.5f,
+                .target = last_in_chain ? (tm_entity_t){0} : (tm_entity_t){.u64 = e.u64 + 1},
+                .rotating_door = {
+                    .pivot = part,
+                    .pivot_closed_rotation = closed,
+                    .pivot_open_rotation = tm_quaternion_from_rotation((tm_vec3_t){0, 1, 0}, 1.5f),
+                    .pivot_rotate_time = 1.0f,
+                },
+            };
+        }
+    }
+
+    bench_entity_components_created(ctx);
+    component__register_engine(ctx);
+
+    level.mgr = (tm_interactable_component_manager_o *)bench_entity__component_manager(ctx, interactable_type);
+    level.engine = ctx->engines;
+    return level;
+}
+
+static void destroy_level(level_t *level)
+{
+    tm_component_manager_o *trans_mgr = level->ctx->types[0].i.manager;
+    bench_entity_context_destroy(level->ctx);
+    free(trans_mgr);
+}
+
+// Returns the number of allocations made after the first frame.
+static uint64_t run_level(const level_desc_t *desc, uint32_t num_frames, bool csv)
+{
+    level_t level = create_level(desc);
+
+    tm_entity_blackboard_value_t blackboard[2] = {
+        {.id = TM_ENTITY_BB__TIME},
+        {.id = TM_ENTITY_BB__DELTA_TIME, .double_value = FRAME_DT},
+    };
+    tm_engine_update_set_t *set = bench_engine_update_set(level.ctx, level.engine, level.first_interactable, level.num_interactables, blackboard, TM_ARRAY_COUNT(blackboard));
+
+    // About one in fifty levers is pulled every frame.
+    const uint32_t pulls_per_frame = tm_max(level.num_levers / 50, 1u);
+
+    double *interact_ns = calloc(num_frames, sizeof(double));
+    double *update_ns = calloc(num_frames, sizeof(double));
+    uint64_t steady_allocations = 0;
+    uint64_t num_interactions = 0;
+    uint32_t peak_active = 0;
+    uint32_t peak_queued = 0;
+    uint64_t rng = 1;
+
+    if (!csv)
+        printf("%u levers, %u doors, chains of %u doors, %u frames:\n", desc->num_levers, desc->num_doors, desc->chain_length, num_frames);
+
+    for (uint32_t frame = 0; frame < num_frames; ++frame)
+    {
+        bench_allocator_reset_stats();
+        blackboard[0].double_value = frame * FRAME_DT;
+
+        const uint64_t t0 = bench_now_ns();
+        for (uint32_t i = 0; i < pulls_per_frame; ++i)
+        {
+            const tm_entity_t lever = {.u64 = level.first_interactable.u64 + next_random(&rng) % level.num_levers};
+            if (can_interact(level.mgr, lever, true))
+            {
+                interact(level.mgr, lever);
+                ++num_interactions;
+            }
+        }
+        const tm_interactable_component_stats_t queued = stats(level.mgr);
+
+        const uint64_t t1 = bench_now_ns();
+        level.engine->update(level.engine->inst, set, 0);
+        const uint64_t t2 = bench_now_ns();
+
+        const tm_interactable_component_stats_t s = stats(level.mgr);
+        const uint64_t allocations = bench_allocator_num_allocations();
+
+        interact_ns[frame] = (double)(t1 - t0);
+        update_ns[frame] = (double)(t2 - t1);
+        peak_active = tm_max(peak_active, s.num_active);
+        peak_queued = tm_max(peak_queued, queued.num_queued);
+
+        // The first frame builds the spatial index and reserves the per-interactable arrays.
+        if (frame)
+            steady_allocations += allocations;
+
+        if (csv)
+            printf("%u,%u,%u,%.0f,%.0f,%llu,%u,%u\n", desc->num_levers, desc->num_doors, frame, interact_ns[frame], update_ns[frame], (unsigned long long)allocations, s.num_active, queued.num_queued);
+    }
+
+    if (!csv)
+    {
+        char label[64];
+        snprintf(label, sizeof(label), "interact, %u pulls/frame", pulls_per_frame);
+        bench_print_summary(label, interact_ns, num_frames, "us");
+        printf("\n");
+        bench_print_summary("engine update", update_ns, num_frames, "us");
+        printf("\n");
+        printf("    %llu interactions, peak %u active, peak %u queued, %llu allocations after the first frame\n", (unsigned long long)num_interactions, peak_active, peak_queued, (unsigned long long)steady_allocations);
+    }
+
+    free(interact_ns);
+    free(update_ns);
+    bench_engine_update_set_free(set);
+    destroy_level(&level);
+    return steady_allocations;
+}
+
+// ---
+// Spawning
+
+enum
+{
+    SPAWN_TYPE__ENTITY = 1,
+    SPAWN_TYPE__INTERACTABLE_COMPONENT,
+    SPAWN_TYPE__LEVER,
+    SPAWN_TYPE__BUTTON,
+    SPAWN_TYPE__ROTATING_DOOR,
+};
+
+#define SPAWN_MAX_PROPERTIES 4
+
+// Object of the stand-in Truth. Properties are stored by property index, each in the array of its type.
+typedef struct spawn_object_t
+{
+    tm_tt_id_t id;
+    uint64_t version;
+    float floats[SPAWN_MAX_PROPERTIES];
+    bool bools[SPAWN_MAX_PROPERTIES];
+    tm_tt_id_t references[SPAWN_MAX_PROPERTIES];
+    tm_tt_id_t subobjects[SPAWN_MAX_PROPERTIES];
+    tm_vec3_t vec3s[SPAWN_MAX_PROPERTIES];
+
+    // Interactable component of an entity asset.
+    tm_tt_id_t component;
+} spawn_object_t;
+
+#define SPAWN_MAX_OBJECTS 16
+
+// Stand-in for The Truth, holding a lever, a button and a door entity asset.
+struct tm_the_truth_o
+{
+    spawn_object_t objects[SPAWN_MAX_OBJECTS];
+    uint32_t num_objects;
+    TM_PAD(4);
+
+    tm_tt_id_t entity_assets[3];
+
+    // Calls made to the stand-in.
+    uint64_t num_calls;
+};
+
+// Spawned entities and the entity assets they are instances of. The animated part of spawned entity `e` is
+// entity `e + num_spawns`.
+typedef struct spawn_scene_t
+{
+    tm_entity_context_o *ctx;
+    tm_the_truth_o *tt;
+    tm_tt_id_t *assets;
+    tm_entity_t first;
+    uint32_t num_spawns;
+    TM_PAD(4);
+} spawn_scene_t;
+
+static spawn_scene_t *spawn_scene;
+
+// The Truth API takes a const Truth for reads, so the call counter is bumped through a cast.
+static void spawn_tt_count_call(const tm_the_truth_o *tt)
+{
+    ++((tm_the_truth_o *)tt)->num_calls;
+}
+
+static const spawn_object_t *spawn_object(const tm_the_truth_o *tt, tm_tt_id_t id)
+{
+    spawn_tt_count_call(tt);
+    return id.index && id.index <= tt->num_objects ? tt->objects + id.index - 1 : 0;
+}
+
+static const tm_the_truth_object_o *spawn_tt__read(const tm_the_truth_o *tt, tm_tt_id_t id)
+{
+    return (const tm_the_truth_object_o *)spawn_object(tt, id);
+}
+
+static bool spawn_tt__is_alive(const tm_the_truth_o *tt, tm_tt_id_t id)
+{
+    return spawn_object(tt, id) != 0;
+}
+
+static uint64_t spawn_tt__version(const tm_the_truth_o *tt, tm_tt_id_t id)
+{
+    const spawn_object_t *o = spawn_object(tt, id);
+    return o ? o->version : 0;
+}
+
+static tm_strhash_t spawn_tt__type_name_hash(const tm_the_truth_o *tt, tm_tt_type_t type)
+{
+    spawn_tt_count_call(tt);
+    switch (type.u64)
+    {
+    case SPAWN_TYPE__INTERACTABLE_COMPONENT:
+        return TM_TT_TYPE_HASH__INTERACTABLE_COMPONENT;
+    case SPAWN_TYPE__LEVER:
+        return TT_TYPE_HASH__INTERACTABLE_LEVER;
+    case SPAWN_TYPE__BUTTON:
+        return TT_TYPE_HASH__INTERACTABLE_BUTTON;
+    case SPAWN_TYPE__ROTATING_DOOR:
+        return TT_TYPE_HASH__INTERACTABLE_ROTATING_DOOR;
+    }
+    return TM_STRHASH(0);
+}
+
+static tm_tt_type_t spawn_tt__object_type_from_name_hash(const tm_the_truth_o *tt, tm_strhash_t name_hash)
+{
+    spawn_tt_count_call(tt);
+    const bool interactable = TM_STRHASH_U64(name_hash) == TM_STRHASH_U64(TM_TT_TYPE_HASH__INTERACTABLE_COMPONENT);
+    return (tm_tt_type_t){interactable ? SPAWN_TYPE__INTERACTABLE_COMPONENT : 0};
+}
+
+static tm_tt_id_t spawn_tt__find_subobject_of_type(const tm_the_truth_o *tt, const tm_the_truth_object_o *obj, uint32_t property, tm_tt_type_t type)
+{
+    spawn_tt_count_call(tt);
+    const spawn_object_t *o = (const spawn_object_t *)obj;
+    return o->component.type == type.u64 ? o->component : (tm_tt_id_t){0};
+}
+
+static tm_tt_id_t spawn_tt__get_subobject(const tm_the_truth_o *tt, const tm_the_truth_object_o *obj, uint32_t property)
+{
+    spawn_tt_count_call(tt);
+    return ((const spawn_object_t *)obj)->subobjects[property];
+}
+
+static tm_tt_id_t spawn_tt__get_reference(const tm_the_truth_o *tt, const tm_the_truth_object_o *obj, uint32_t property)
+{
+    spawn_tt_count_call(tt);
+    return ((const spawn_object_t *)obj)->references[property];
+}
+
+static float spawn_tt__get_float(const tm_the_truth_o *tt, const tm_the_truth_object_o *obj, uint32_t property)
+{
+    spawn_tt_count_call(tt);
+    return ((const spawn_object_t *)obj)->floats[property];
+}
+
+static bool spawn_tt__get_bool(const tm_the_truth_o *tt, const tm_the_truth_object_o *obj, uint32_t property)
+{
+    spawn_tt_count_call(tt);
+    return ((const spawn_object_t *)obj)->bools[property];
+}
+
+static tm_vec3_t spawn_tt__get_vec3(const tm_the_truth_o *tt, const tm_the_truth_object_o *obj, uint32_t property)
+{
+    spawn_tt_count_call(tt);
+    return ((const spawn_object_t *)obj)->vec3s[property];
+}
+
+static struct tm_the_truth_api spawn_tt_api = {
+    .read = spawn_tt__read,
+    .is_alive = spawn_tt__is_alive,
+    .version = spawn_tt__version,
+    .type_name_hash = spawn_tt__type_name_hash,
+    .object_type_from_name_hash = spawn_tt__object_type_from_name_hash,
+    .find_subobject_of_type = spawn_tt__find_subobject_of_type,
+    .get_subobject = spawn_tt__get_subobject,
+    .get_reference = spawn_tt__get_reference,
+    .get_float = spawn_tt__get_float,
+    .get_bool = spawn_tt__get_bool,
+};
+
+static struct tm_the_truth_common_types_api spawn_tt_common_types_api = {
+    .get_vec3 = spawn_tt__get_vec3,
+};
+
+static tm_tt_id_t spawn_entity__asset(tm_entity_context_o *ctx, tm_entity_t e)
+{
+    return spawn_scene->assets[e.u64 - spawn_scene->first.u64];
+}
+
+static tm_the_truth_o *spawn_entity__the_truth(tm_entity_context_o *ctx)
+{
+    return spawn_scene->tt;
+}
+
+// The only entity references of the assets are to the animated part.
+static tm_entity_t spawn_entity__resolve_asset_reference(tm_entity_context_o *ctx, tm_entity_t e, tm_tt_id_t asset)
+{
+    return (tm_entity_t){.u64 = e.u64 + spawn_scene->num_spawns};
+}
+
+static tm_tt_id_t spawn_tt_add(tm_the_truth_o *tt, uint32_t type)
+{
+    spawn_object_t *o = tt->objects + tt->num_objects++;
+    *o = (spawn_object_t){.id = {.type = type, .index = tt->num_objects}, .version = 1};
+    return o->id;
+}
+
+// Adds an entity asset with an interactable component of description type `desc_type`.
+static tm_tt_id_t spawn_tt_add_entity_asset(tm_the_truth_o *tt, uint32_t desc_type)
+{
+    const tm_tt_id_t entity = spawn_tt_add(tt, SPAWN_TYPE__ENTITY);
+    const tm_tt_id_t component = spawn_tt_add(tt, SPAWN_TYPE__INTERACTABLE_COMPONENT);
+    const tm_tt_id_t desc = spawn_tt_add(tt, desc_type);
+    const tm_tt_id_t part = spawn_tt_add(tt, SPAWN_TYPE__ENTITY);
+
+    tt->objects[entity.index - 1].component = component;
+
+    spawn_object_t *c = tt->objects + component.index - 1;
+    c->subobjects[INTERACTABLE_COMPONENT_PROP__DESC] = desc;
+    c->floats[INTERACTABLE_COMPONENT_PROP__TARGET_ACTIVATION_DELAY] = 0.25f;
+    c->bools[INTERACTABLE_COMPONENT_PROP__PLAYER_CAN_ACTIVATE] = true;
+
+    // Lever, button and door properties all have the same layout: animated entity, axis, angle or
+    // distance, time.
+    spawn_object_t *d = tt->objects + desc.index - 1;
+    d->references[INTERACTABLE_LEVER_PROP__HANDLE] = part;
+    d->vec3s[INTERACTABLE_LEVER_PROP__HANDLE_ROTATE_AXIS] = (tm_vec3_t){0, 1, 0};
+    d->floats[INTERACTABLE_LEVER_PROP__HANDLE_ROTATE_ANGLE] = desc_type == SPAWN_TYPE__BUTTON ? 0.1f : 90.0f;
+    d->floats[INTERACTABLE_LEVER_PROP__HANDLE_OPEN_TIME] = 0.5f;
+    return entity;
+}
+
+// Times `num_runs` runs of `component__asset_loaded()` on all spawned entities and returns the number of
+// calls to The Truth per spawn.
+static double run_spawns(spawn_scene_t *scene, tm_interactable_component_manager_o *mgr, tm_component_type_t type, uint32_t num_runs, bool use_cache, double *run_ns)
+{
+    scene->tt->num_calls = 0;
+    for (uint32_t run = 0; run < num_runs; ++run)
+    {
+        // Each run spawns the level anew.
+        tm_carray_resize(mgr->descriptors, 0, &mgr->allocator);
+        tm_hash_clear(&mgr->descriptor_lookup);
+
+        const uint64_t t0 = bench_now_ns();
+        for (uint32_t i = 0; i < scene->num_spawns; ++i)
+        {
+            const tm_entity_t e = {.u64 = scene->first.u64 + i};
+            if (!use_cache)
+            {
+                tm_carray_resize(mgr->descriptors, 0, &mgr->allocator);
+                tm_hash_clear(&mgr->descriptor_lookup);
+            }
+            component__asset_loaded((tm_component_manager_o *)mgr, 0, e, bench_entity__write_component(scene->ctx, e, type));
+        }
+        run_ns[run] = (double)(bench_now_ns() - t0);
+    }
+    return (double)scene->tt->num_calls / ((double)num_runs * scene->num_spawns);
+}
+
+static void run_spawn_bench(uint32_t num_spawns, uint32_t num_runs)
+{
+    tm_the_truth_o *tt = calloc(1, sizeof(*tt));
+    for (uint32_t i = 0; i < TM_ARRAY_COUNT(tt->entity_assets); ++i)
+        tt->entity_assets[i] = spawn_tt_add_entity_asset(tt, SPAWN_TYPE__LEVER + i);
+
+    tm_entity_context_o *ctx = bench_entity_context_create(2 * num_spawns);
+    const tm_component_type_t transform_type = bench_entity_register_plain_component(ctx, TM_TT_TYPE__TRANSFORM_COMPONENT, sizeof(tm_transform_component_t));
+    struct tm_transform_component_manager_o trans_mgr = {.ctx = ctx, .type = transform_type};
+    ctx->types[transform_type.index].i.manager = (tm_component_manager_o *)&trans_mgr;
+
+    component__create(ctx);
+    const tm_component_type_t interactable_type = bench_entity__lookup_component_type(ctx, TM_TT_TYPE_HASH__INTERACTABLE_COMPONENT);
+
+    spawn_scene_t scene = {
+        .ctx = ctx,
+        .tt = tt,
+        .assets = calloc(num_spawns, sizeof(tm_tt_id_t)),
+        .num_spawns = num_spawns,
+    };
+    for (uint32_t i = 0; i < 2 * num_spawns; ++i)
+    {
+        const tm_entity_t e = bench_entity_create(ctx);
+        if (!i)
+            scene.first = e;
+        tm_transform_component_t *t = bench_entity_add_component(ctx, e, transform_type);
+        t->world.rot = (tm_vec4_t){0, 0, 0, 1};
+        t->world.scl = (tm_vec3_t){1, 1, 1};
+        if (i < num_spawns)
+        {
+            bench_entity_add_component(ctx, e, interactable_type);
+            scene.assets[i] = tt->entity_assets[i % TM_ARRAY_COUNT(tt->entity_assets)];
+        }
+    }
+    bench_entity_components_created(ctx);
+
+    spawn_scene = &scene;
+    tm_entity_api->asset = spawn_entity__asset;
+    tm_entity_api->the_truth = spawn_entity__the_truth;
+    tm_entity_api->resolve_asset_reference = spawn_entity__resolve_asset_reference;
+    tm_the_truth_api = &spawn_tt_api;
+    tm_the_truth_common_types_api = &spawn_tt_common_types_api;
+
+    tm_interactable_component_manager_o *mgr = (tm_interactable_component_manager_o *)bench_entity__component_manager(ctx, interactable_type);
+    double *run_ns = calloc(num_runs, sizeof(double));
+
+    printf("%u spawns of %u interactable assets, %u runs:\n", num_spawns, (uint32_t)TM_ARRAY_COUNT(tt->entity_assets), num_runs);
+    for (uint32_t use_cache = 0; use_cache < 2; ++use_cache)
+    {
+        const double calls = run_spawns(&scene, mgr, interactable_type, num_runs, use_cache, run_ns);
+        const bench_summary_t s = bench_print_summary(use_cache ? "asset_loaded, cached" : "asset_loaded, uncached", run_ns, num_runs, "ms");
+        printf(", %6.1f ns/spawn, %5.1f Truth calls/spawn\n", s.median / num_spawns, calls);
+    }
+
+    spawn_scene = 0;
+    free(run_ns);
+    free(scene.assets);
+    bench_entity_context_destroy(ctx);
+    free(tt);
+}
+
+// ---
+// Active lookup
+
+// What `can_interact()` did before `active_lookup`.
+static bool scan_active(const tm_interactable_component_manager_o *mgr, tm_entity_t e)
+{
+    const uint32_t num_active = (uint32_t)tm_carray_size(mgr->active);
+    for (uint32_t i = 0; i < num_active; ++i)
+    {
+        if (mgr->active[i].interactable.u64 == e.u64)
+            return true;
+    }
+    return false;
+}
+
+// Sum of the lookup results, so that the lookups can't be optimized away.
+static volatile uint64_t active_sink;
+
+static void run_active_lookup_bench(uint32_t num_active)
+{
+    // Only the first half of the levers is made active.
+    const level_desc_t desc = {.num_levers = 2 * num_active, .chain_length = 1};
+    level_t level = create_level(&desc);
+    tm_interactable_component_manager_o *mgr = level.mgr;
+
+    for (uint32_t i = 0; i < num_active; ++i)
+    {
+        const tm_entity_t e = {.u64 = level.first_interactable.u64 + i};
+        tm_hash_add(&mgr->active_lookup, e.u64, (uint32_t)tm_carray_size(mgr->active));
+        tm_carray_push(mgr->active, ((active_interaction_t){.interactable = e}), &mgr->allocator);
+    }
+
+    const uint32_t num_lookups = 2 * num_active;
+    tm_entity_t *lookups = calloc(num_lookups, sizeof(*lookups));
+    uint64_t rng = 1;
+    for (uint32_t i = 0; i < num_lookups; ++i)
+        lookups[i] = (tm_entity_t){.u64 = level.first_interactable.u64 + next_random(&rng) % level.num_levers};
+
+    double sample_ns[ACTIVE_LOOKUP_SAMPLES];
+    printf("%u active interactables, %u lookups, half of them misses:\n", num_active, num_lookups);
+    for (uint32_t use_hash = 0; use_hash < 2; ++use_hash)
+    {
+        // A scan of 10k interactions is slow enough that a sample only looks up part of the entities.
+        const uint32_t lookups_per_sample = use_hash ? num_lookups : tm_max(num_lookups / ACTIVE_LOOKUP_SAMPLES, 1u);
+        uint64_t found = 0;
+        for (uint32_t sample = 0; sample < ACTIVE_LOOKUP_SAMPLES; ++sample)
+        {
+            const uint32_t first = use_hash ? 0 : (sample * lookups_per_sample) % num_lookups;
+            const uint64_t t0 = bench_now_ns();
+            for (uint32_t i = 0; i < lookups_per_sample; ++i)
+            {
+                const tm_entity_t e = lookups[(first + i) % num_lookups];
+                found += use_hash ? tm_hash_has(&mgr->active_lookup, e.u64) : scan_active(mgr, e);
+            }
+            sample_ns[sample] = (double)(bench_now_ns() - t0) / lookups_per_sample;
+        }
+        active_sink += found;
+
+        bench_print_summary(use_hash ? "active_lookup" : "scan of active", sample_ns, ACTIVE_LOOKUP_SAMPLES, "ns");
+        printf(" per lookup, %.1f%% found\n", 100.0 * found / ((double)lookups_per_sample * ACTIVE_LOOKUP_SAMPLES));
+    }
+
+    free(lookups);
+    destroy_level(&level);
+}
+
+int main(int argc, char **argv)
+{
+    tm_entity_api = bench_entity_api();
+    tm_os_api = bench_os_api();
+    tm_logger_api = bench_logger_api();
+
+    uint32_t num_frames = DEFAULT_FRAMES;
+    uint32_t num_spawns = DEFAULT_SPAWNS;
+    uint32_t num_spawn_runs = DEFAULT_SPAWN_RUNS;
+    uint32_t num_active = DEFAULT_ACTIVE;
+    level_desc_t custom = {.chain_length = 2};
+    bool csv = false;
+
+    const bench_option_t options[] = {
+        {.name = "--frames", .value = &num_frames, .min = 1},
+        {.name = "--levers", .value = &custom.num_levers, .min = 1},
+        {.name = "--doors", .value = &custom.num_doors},
+        {.name = "--chain", .value = &custom.chain_length, .min = 1},
+        {.name = "--csv", .flag = &csv},
+        {.name = "--spawns", .value = &num_spawns, .min = 1},
+        {.name = "--spawn-runs", .value = &num_spawn_runs, .min = 1},
+        {.name = "--active", .value = &num_active, .min = 1},
+    };
+    if (!bench_parse_args(argc, argv, options, TM_ARRAY_COUNT(options)))
+        return 1;
+
+    if (csv)
+        printf("levers,doors,frame,interact_ns,update_ns,allocations,active,queued\n");
+
+    uint64_t steady_allocations = 0;
+    if (custom.num_levers)
+    {
+        steady_allocations += run_level(&custom, num_frames, csv);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < TM_ARRAY_COUNT(default_levels); ++i)
+        {
+            level_desc_t desc = default_levels[i];
+            desc.chain_length = custom.chain_length;
+            steady_allocations += run_level(&desc, num_frames, csv);
+        }
+    }
+
+    if (!csv)
+    {
+        run_spawn_bench(num_spawns, num_spawn_runs);
+        run_active_lookup_bench(num_active);
+    }
+
+    if (steady_allocations)
+    {
+        fprintf(stderr, "FAILED: %llu allocations after the first frame.\n", (unsigned long long)steady_allocations);
+        return 1;
+    }
+    return 0;
+}
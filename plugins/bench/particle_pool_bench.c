@@ -0,0 +1,233 @@
+// Soak run of the particle effect pool (see `plugins/gameplay/shared/particle_pool.inl`) that the
+// third-person sample uses for its checkpoint effects. It plays a long session at 60 Hz in which the player
+// reaches checkpoints at random intervals, from several per second, which uses up the pool and reuses
+// effects that are still showing, to several seconds apart.
+//
+// The effects are stand-ins that record how they were restarted and disabled. After every frame, the run
+// checks that:
+//
+// * Every spawned effect was restarted exactly once, at the spawn position, and is enabled.
+// * Every effect is disabled once it has been shown for its lifetime, and only then.
+// * No effect is disabled twice and the pool keeps the same entities.
+//
+// The benchmark fails if any check fails. It also reports the time per frame spent in the pool.
+//
+//     particle_pool_bench [--spawns N]
+
+#include <foundation/allocator.h>
+#include <foundation/api_registry.h>
+#include <foundation/log.h>
+#include <foundation/macros.h>
+#include <foundation/os.h>
+
+#include <plugins/entity/entity.h>
+
+#include <foundation/math.inl>
+
+#include "../shared/bench_harness.inl"
+
+#include "../gameplay/shared/particle_pool.inl"
+#include "../gameplay/shared/random.inl"
+
+#define DEFAULT_SPAWNS 100000
+
+#define FRAME_DT (1.0 / 60.0)
+
+// Same as in the third-person sample.
+#define PARTICLE_LIFETIME 4.0
+
+// Effects are entities `1` to `PARTICLE_POOL_SIZE`.
+#define FIRST_EFFECT 1
+
+// State of a stand-in effect.
+typedef struct effect_t
+{
+    tm_vec3_t pos;
+    bool enabled;
+    TM_PAD(3);
+
+    uint32_t num_restarts;
+    uint32_t num_disables;
+    TM_PAD(4);
+} effect_t;
+
+typedef struct soak_t
+{
+    effect_t effects[PARTICLE_POOL_SIZE];
+
+    // Restarts of effects that were still showing.
+    uint64_t num_steals;
+
+    // Calls to `restart()` and `disable()` with an entity that isn't one of the effects.
+    uint64_t num_unknown_entities;
+
+    // Calls to `disable()` on effects that were already disabled.
+    uint64_t num_double_disables;
+} soak_t;
+
+static effect_t *effect(soak_t *soak, tm_entity_t e)
+{
+    if (e.u64 < FIRST_EFFECT || e.u64 >= FIRST_EFFECT + PARTICLE_POOL_SIZE)
+    {
+        ++soak->num_unknown_entities;
+        return 0;
+    }
+    return soak->effects + e.u64 - FIRST_EFFECT;
+}
+
+static void effect__restart(void *inst, tm_entity_t e, tm_vec3_t pos)
+{
+    soak_t *soak = inst;
+    effect_t *fx = effect(soak, e);
+    if (!fx)
+        return;
+
+    soak->num_steals += fx->enabled;
+    fx->pos = pos;
+    fx->enabled = true;
+    ++fx->num_restarts;
+}
+
+static void effect__disable(void *inst, tm_entity_t e)
+{
+    soak_t *soak = inst;
+    effect_t *fx = effect(soak, e);
+    if (!fx)
+        return;
+
+    soak->num_double_disables += !fx->enabled;
+    fx->enabled = false;
+    ++fx->num_disables;
+}
+
+// Frames until the next checkpoint: between a tenth of a second and six seconds.
+static uint32_t frames_to_next_checkpoint(uint64_t *rng)
+{
+    return 6 + (uint32_t)(next_random(rng) % 360);
+}
+
+// Checks the effects against the pool after a frame. Returns the number of failed checks.
+static uint32_t check_pool(const soak_t *soak, const particle_pool_t *pool, double t)
+{
+    uint32_t failed = 0;
+
+    failed += pool->num_entities != PARTICLE_POOL_SIZE;
+    for (uint32_t i = 0; i < pool->num_entities; ++i)
+    {
+        failed += pool->entities[i].u64 != FIRST_EFFECT + i;
+
+        const effect_t *fx = soak->effects + i;
+        const bool expired = t - pool->spawn_time[i] >= PARTICLE_LIFETIME;
+        failed += fx->enabled != pool->active[i];
+        failed += pool->active[i] && expired;
+    }
+    return failed;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t num_spawns = DEFAULT_SPAWNS;
+
+    const bench_option_t options[] = {
+        {.name = "--spawns", .value = &num_spawns, .min = 1},
+    };
+    if (!bench_parse_args(argc, argv, options, TM_ARRAY_COUNT(options)))
+        return 1;
+
+    soak_t soak = {0};
+    const particle_effect_i fx_i = {
+        .inst = &soak,
+        .restart = effect__restart,
+        .disable = effect__disable,
+    };
+
+    // Like a newly created effect entity, the effects start out enabled, until they are added to the pool.
+    for (uint32_t i = 0; i < PARTICLE_POOL_SIZE; ++i)
+        soak.effects[i].enabled = true;
+
+    particle_pool_t pool = {0};
+    for (uint32_t i = 0; i < PARTICLE_POOL_SIZE; ++i)
+        particle_pool_add(&pool, &fx_i, (tm_entity_t){.u64 = FIRST_EFFECT + i});
+
+    uint32_t failed = 0;
+    for (uint32_t i = 0; i < PARTICLE_POOL_SIZE; ++i)
+        failed += soak.effects[i].enabled || soak.effects[i].num_disables != 1;
+    failed += particle_pool_add(&pool, &fx_i, (tm_entity_t){.u64 = FIRST_EFFECT + PARTICLE_POOL_SIZE});
+
+    uint64_t rng = 1;
+    uint32_t spawns = 0;
+    uint32_t next_checkpoint = frames_to_next_checkpoint(&rng);
+    uint64_t num_frames = 0;
+
+    // The frames are timed in samples of 60 frames.
+    const uint64_t max_samples = (uint64_t)num_spawns * 366 / 60 + 1;
+    double *sample_ns = calloc(max_samples, sizeof(double));
+    uint32_t num_samples = 0;
+    uint64_t ns = 0;
+
+    while (spawns < num_spawns)
+    {
+        const double t = (double)num_frames * FRAME_DT;
+
+        uint32_t restarts_before[PARTICLE_POOL_SIZE];
+        for (uint32_t i = 0; i < PARTICLE_POOL_SIZE; ++i)
+            restarts_before[i] = soak.effects[i].num_restarts;
+
+        const uint64_t t0 = bench_now_ns();
+        particle_pool_recycle(&pool, &fx_i, t, PARTICLE_LIFETIME);
+
+        tm_entity_t spawned = {0};
+        const tm_vec3_t pos = {(float)(spawns % 8), 0, (float)(spawns / 8 % 8)};
+        if (!--next_checkpoint)
+            spawned = particle_pool_spawn(&pool, &fx_i, pos, t);
+        ns += bench_now_ns() - t0;
+
+        // Only the spawned effect, if any, is restarted.
+        for (uint32_t i = 0; i < PARTICLE_POOL_SIZE; ++i)
+        {
+            const bool is_spawned = spawned.u64 == FIRST_EFFECT + i;
+            failed += soak.effects[i].num_restarts != restarts_before[i] + is_spawned;
+        }
+
+        if (!next_checkpoint)
+        {
+            const effect_t *fx = effect(&soak, spawned);
+            failed += !fx || !fx->enabled || fx->pos.x != pos.x || fx->pos.z != pos.z;
+            next_checkpoint = frames_to_next_checkpoint(&rng);
+            ++spawns;
+        }
+
+        failed += check_pool(&soak, &pool, t);
+
+        if (++num_frames % 60 == 0 && num_samples < max_samples)
+        {
+            sample_ns[num_samples++] = (double)ns / 60;
+            ns = 0;
+        }
+    }
+
+    uint64_t num_restarts = 0;
+    uint64_t num_disables = 0;
+    for (uint32_t i = 0; i < PARTICLE_POOL_SIZE; ++i)
+    {
+        num_restarts += soak.effects[i].num_restarts;
+        num_disables += soak.effects[i].num_disables;
+    }
+    failed += num_restarts != spawns;
+    failed += soak.num_unknown_entities != 0;
+    failed += soak.num_double_disables != 0;
+
+    printf("%u spawns in %.1f hours of play, pool of %u effects:\n", spawns, num_frames * FRAME_DT / 3600.0, PARTICLE_POOL_SIZE);
+    bench_print_summary("pool, per frame", sample_ns, num_samples, "ns");
+    printf("\n");
+    printf("    %llu restarts, %llu of them of effects still showing, %llu disables\n", (unsigned long long)num_restarts, (unsigned long long)soak.num_steals, (unsigned long long)num_disables);
+
+    free(sample_ns);
+
+    if (failed)
+    {
+        fprintf(stderr, "FAILED: %u checks failed.\n", failed);
+        return 1;
+    }
+    return 0;
+}
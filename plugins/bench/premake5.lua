@@ -0,0 +1,115 @@
+-- premake5.lua
+-- version: premake-5.0.0-alpha14
+
+-- %TM_SDK_DIR% should be set to the directory of The Machinery SDK
+
+-- Headless benchmarks of the sample engines. They only use headers from the SDK and run on Linux without the
+-- editor or a GPU:
+--
+--     bin/Release/custom_component_bench
+--     bin/Release/bob_bench
+--     bin/Release/blackboard_bench
+--     bin/Release/anim_vars_bench
+--     bin/Release/interaction_system_bench
+--     bin/Release/input_state_bench
+--     bin/Release/particle_pool_bench
+
+workspace "bench"
+    configurations {"Debug", "Release"}
+    language "C++"
+    cppdialect "C++11"
+    flags { "FatalWarnings"}
+    warnings "Extra"
+    inlining "Auto"
+    sysincludedirs { "" }
+    targetdir "bin/%{cfg.buildcfg}"
+
+filter {"system:linux"}
+    platforms { "Linux" }
+
+filter {"platforms:Linux"}
+    defines { "TM_OS_LINUX", "TM_OS_POSIX" }
+    includedirs { "${TM_SDK_DIR}/headers" }
+    architecture "x64"
+    toolset "clang"
+    buildoptions {
+        "-fms-extensions",                   -- Allow anonymous struct as C inheritance.
+        "-g",                                -- Debugging.
+        "-mavx",                             -- AVX.
+        "-mfma",                             -- FMA.
+        "-fcommon",                          -- Allow tentative definitions
+        "-pthread",                          -- Worker threads of the stand-in job system.
+    }
+    disablewarnings {
+        "missing-field-initializers",   -- = {0} is OK.
+        "unused-parameter",             -- Useful for documentation purposes.
+        "unused-local-typedef",         -- We don't always use all typedefs.
+        "missing-braces",               -- = {0} is OK.
+        "microsoft-anon-tag",           -- Allow anonymous structs.
+    }
+    links { "m", "pthread" }
+    removeflags {"FatalWarnings"}
+
+filter "configurations:Debug"
+    defines { "TM_CONFIGURATION_DEBUG", "DEBUG" }
+    symbols "On"
+
+filter "configurations:Release"
+    defines { "TM_CONFIGURATION_RELEASE" }
+    optimize "On"
+
+project "custom_component_bench"
+    location "build/custom_component_bench"
+    targetname "custom_component_bench"
+    kind "ConsoleApp"
+    language "C++"
+    files {"custom_component_bench.c", "../shared/bench_harness.inl", "../shared/bench_job_system.inl"}
+    sysincludedirs { "" }
+
+project "bob_bench"
+    location "build/bob_bench"
+    targetname "bob_bench"
+    kind "ConsoleApp"
+    language "C++"
+    files {"bob_bench.c", "../shared/bench_harness.inl", "../shared/bench_job_system.inl"}
+    sysincludedirs { "" }
+
+project "blackboard_bench"
+    location "build/blackboard_bench"
+    targetname "blackboard_bench"
+    kind "ConsoleApp"
+    language "C++"
+    files {"blackboard_bench.c", "../shared/bench_harness.inl", "../shared/blackboard_cache.inl"}
+    sysincludedirs { "" }
+
+project "anim_vars_bench"
+    location "build/anim_vars_bench"
+    targetname "anim_vars_bench"
+    kind "ConsoleApp"
+    language "C++"
+    files {"anim_vars_bench.c", "../shared/bench_harness.inl", "../gameplay/shared/anim_vars.inl", "../gameplay/shared/random.inl"}
+    sysincludedirs { "" }
+
+project "interaction_system_bench"
+    location "build/interaction_system_bench"
+    targetname "interaction_system_bench"
+    kind "ConsoleApp"
+    language "C++"
+    files {"interaction_system_bench.c", "../shared/bench_harness.inl", "../gameplay/shared/random.inl"}
+    sysincludedirs { "" }
+
+project "input_state_bench"
+    location "build/input_state_bench"
+    targetname "input_state_bench"
+    kind "ConsoleApp"
+    language "C++"
+    files {"input_state_bench.c", "../shared/bench_harness.inl", "../gameplay/shared/input_state.inl", "../gameplay/shared/random.inl"}
+    sysincludedirs { "" }
+
+project "particle_pool_bench"
+    location "build/particle_pool_bench"
+    targetname "particle_pool_bench"
+    kind "ConsoleApp"
+    language "C++"
+    files {"particle_pool_bench.c", "../shared/bench_harness.inl", "../gameplay/shared/particle_pool.inl", "../gameplay/shared/random.inl"}
+    sysincludedirs { "" }
@@ -3,16 +3,32 @@ static struct tm_transform_component_api* tm_transform_component_api;
 static struct tm_temp_allocator_api* tm_temp_allocator_api;
 static struct tm_the_truth_api* tm_the_truth_api;
 static struct tm_localizer_api* tm_localizer_api;
+static struct tm_job_system_api* tm_job_system_api;
+static struct tm_properties_view_api* tm_properties_view_api;
+static struct tm_ui_api* tm_ui_api;
 
+#include <plugins/editor_views/properties.h>
 #include <plugins/entity/entity.h>
 #include <plugins/entity/transform_component.h>
 #include <plugins/the_machinery_shared/component_interfaces/editor_ui_interface.h>
+#include <plugins/ui/ui.h>
 
+#include <foundation/allocator.h>
 #include <foundation/api_registry.h>
 #include <foundation/carray.inl>
+#include <foundation/job_system.h>
 #include <foundation/localizer.h>
 #include <foundation/math.inl>
 #include <foundation/the_truth.h>
+#include <foundation/undo.h>
+
+#include "../shared/blackboard_cache.inl"
+
+#include <math.h>
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#endif
 
 #define TM_TT_TYPE__CUSTOM_COMPONENT "tm_custom_component"
 #define TM_TT_TYPE_HASH__CUSTOM_COMPONENT TM_STATIC_HASH("tm_custom_component", 0x355309758b21930cULL)
@@ -20,14 +36,69 @@ static struct tm_localizer_api* tm_localizer_api;
 enum {
     TM_TT_PROP__CUSTOM_COMPONENT__FREQUENCY, // float
     TM_TT_PROP__CUSTOM_COMPONENT__AMPLITUDE, // float
+    TM_TT_PROP__CUSTOM_COMPONENT__MOTION, // uint32_t (enum custom_motion)
+    TM_TT_PROP__CUSTOM_COMPONENT__LOD, // bool
+};
+
+// The motions the component can do. Each is a function of the time, `frequency`, `amplitude` and the pose the
+// entity had when the engine first saw it, so an entity can be evaluated at any time without knowing its
+// previous pose.
+enum custom_motion {
+    // Moves up and down: y = y0 + amplitude * sin(t * frequency).
+    CUSTOM_MOTION__BOB,
+
+    // Spins around its Y axis at `frequency` radians per second.
+    CUSTOM_MOTION__ROTATE,
+
+    // Circles its starting position in the XZ plane, with radius `amplitude` at `frequency` radians per
+    // second.
+    CUSTOM_MOTION__ORBIT,
+
+    // Moves back and forth along X between its starting position and `amplitude` units from it, completing
+    // a round trip every 2 pi / `frequency` seconds.
+    CUSTOM_MOTION__PING_PONG,
+
+    CUSTOM_MOTION__COUNT,
 };
 
 struct tm_custom_component_t {
-    float y0;
+    // Pose of the entity when the engine first saw it. Valid if `has_origin` is set.
+    tm_vec3_t origin;
+    tm_vec4_t origin_rot;
+
+    // enum custom_motion
+    uint32_t motion;
     float frequency;
     float amplitude;
+
+    bool has_origin;
+
+    // If set, the entity is updated less often, or not at all, when it is far from the camera. See
+    // `CUSTOM_LOD_DISTANCE` and `CUSTOM_CULL_DISTANCE`.
+    bool lod;
+    TM_PAD(2);
+};
+
+// Blackboard values read by the engine, in the order they are given to its `blackboard_cache_t`.
+enum {
+    CUSTOM_BB__TIME,
+    CUSTOM_BB__DELTA_TIME,
+    CUSTOM_BB__CAMERA_TRANSFORM,
+    CUSTOM_BB__COUNT,
 };
 
+// The component manager only holds what the engine needs to keep between updates.
+typedef struct custom_component_manager_t {
+    tm_allocator_i allocator;
+    tm_entity_context_o* ctx;
+    blackboard_cache_t blackboard;
+
+    // Set if the engine saw an entity with `lod` set in its last update. Entities are only skipped if this is
+    // set, so that the engine doesn't have to list the entities it updated when no entity uses LOD.
+    bool lod_used;
+    TM_PAD(7);
+} custom_component_manager_t;
+
 static const char* component__category(void)
 {
     return TM_LOCALIZE("Samples");
@@ -37,11 +108,55 @@ static tm_ci_editor_ui_i* editor_aspect = &(tm_ci_editor_ui_i){
     .category = component__category
 };
 
+// Special UI for editing the component in property editor, so that the motion can be picked by name.
+static float component_properties_ui(struct tm_properties_ui_args_t* args, tm_rect_t item_rect, tm_tt_id_t component_id)
+{
+    tm_the_truth_o* tt = args->tt;
+
+    const char* motion_names[CUSTOM_MOTION__COUNT] = {
+        [CUSTOM_MOTION__BOB] = TM_LOCALIZE("Bob"),
+        [CUSTOM_MOTION__ROTATE] = TM_LOCALIZE("Rotate"),
+        [CUSTOM_MOTION__ORBIT] = TM_LOCALIZE("Orbit"),
+        [CUSTOM_MOTION__PING_PONG] = TM_LOCALIZE("Ping Pong"),
+    };
+
+    const tm_rect_t dropdown_r = tm_properties_view_api->ui_label_split(args, item_rect, TM_LOCALIZE("Motion"), 0);
+
+    const tm_ui_dropdown_t d = {
+        .rect = dropdown_r,
+        .items = motion_names,
+        .num_items = TM_ARRAY_COUNT(motion_names),
+    };
+
+    const uint32_t motion = tm_the_truth_api->get_uint32_t(tt, tm_tt_read(tt, component_id), TM_TT_PROP__CUSTOM_COMPONENT__MOTION);
+    uint32_t selected_idx = motion < CUSTOM_MOTION__COUNT ? motion : CUSTOM_MOTION__BOB;
+
+    if (tm_ui_api->dropdown(args->ui, args->uistyle, &d, &selected_idx)) {
+        const tm_tt_undo_scope_t undo_scope = tm_the_truth_api->create_undo_scope(tt, TM_LOCALIZE("Change motion"));
+        tm_the_truth_object_o* component_w = tm_the_truth_api->write(tt, component_id);
+        tm_the_truth_api->set_uint32_t(tt, component_w, TM_TT_PROP__CUSTOM_COMPONENT__MOTION, selected_idx);
+        tm_the_truth_api->commit(tt, component_w, undo_scope);
+        args->undo_stack->add(args->undo_stack->inst, args->tt, undo_scope);
+    }
+
+    item_rect.y += item_rect.h + args->metrics[TM_PROPERTIES_METRIC_MARGIN];
+    item_rect.y = tm_properties_view_api->ui_float(args, item_rect, TM_LOCALIZE("Frequency"), TM_LOCALIZE("Speed of the motion, in radians per second"), component_id, TM_TT_PROP__CUSTOM_COMPONENT__FREQUENCY, 0);
+    item_rect.y = tm_properties_view_api->ui_float(args, item_rect, TM_LOCALIZE("Amplitude"), TM_LOCALIZE("Distance the entity moves from its starting position. Not used by Rotate"), component_id, TM_TT_PROP__CUSTOM_COMPONENT__AMPLITUDE, 0);
+    item_rect.y = tm_properties_view_api->ui_bool(args, item_rect, TM_LOCALIZE("Distance LOD"), TM_LOCALIZE("Update the entity less often when it is far from the camera, and not at all when it is very far"), component_id, TM_TT_PROP__CUSTOM_COMPONENT__LOD);
+    return item_rect.y;
+}
+
+static tm_properties_aspect_i* properties_aspect = &(tm_properties_aspect_i){
+    .custom_ui = component_properties_ui,
+};
+
 static void truth__create_types(struct tm_the_truth_o* tt)
 {
     tm_the_truth_property_definition_t custom_component_properties[] = {
         [TM_TT_PROP__CUSTOM_COMPONENT__FREQUENCY] = { "frequency", TM_THE_TRUTH_PROPERTY_TYPE_FLOAT },
         [TM_TT_PROP__CUSTOM_COMPONENT__AMPLITUDE] = { "amplitude", TM_THE_TRUTH_PROPERTY_TYPE_FLOAT },
+        [TM_TT_PROP__CUSTOM_COMPONENT__MOTION] = { "motion", TM_THE_TRUTH_PROPERTY_TYPE_UINT32_T },
+        [TM_TT_PROP__CUSTOM_COMPONENT__LOD] = { "lod", TM_THE_TRUTH_PROPERTY_TYPE_BOOL },
     };
 
     const tm_tt_type_t custom_component_type = tm_the_truth_api->create_object_type(tt, TM_TT_TYPE__CUSTOM_COMPONENT, custom_component_properties, TM_ARRAY_COUNT(custom_component_properties));
@@ -49,60 +164,400 @@ static void truth__create_types(struct tm_the_truth_o* tt)
     tm_the_truth_api->set_default_object(tt, custom_component_type, default_object);
 
     tm_tt_set_aspect(tt, custom_component_type, tm_ci_editor_ui_i, editor_aspect);
+    tm_tt_set_aspect(tt, custom_component_type, tm_properties_aspect_i, properties_aspect);
 }
 
 static bool component__load_asset(tm_component_manager_o* man,struct tm_entity_commands_o *commands, tm_entity_t e, void* c_vp, const tm_the_truth_o* tt, tm_tt_id_t asset)
 {
     struct tm_custom_component_t* c = c_vp;
     const tm_the_truth_object_o* asset_r = tm_tt_read(tt, asset);
-    c->y0 = 0;
-    c->frequency = tm_the_truth_api->get_float(tt, asset_r, TM_TT_PROP__CUSTOM_COMPONENT__FREQUENCY);
-    c->amplitude = tm_the_truth_api->get_float(tt, asset_r, TM_TT_PROP__CUSTOM_COMPONENT__AMPLITUDE);
+    const uint32_t motion = tm_the_truth_api->get_uint32_t(tt, asset_r, TM_TT_PROP__CUSTOM_COMPONENT__MOTION);
+    // The starting pose is captured by the engine the first time it runs on the entity, as the transform
+    // might not be loaded yet.
+    *c = (struct tm_custom_component_t){
+        .motion = motion < CUSTOM_MOTION__COUNT ? motion : CUSTOM_MOTION__BOB,
+        .frequency = tm_the_truth_api->get_float(tt, asset_r, TM_TT_PROP__CUSTOM_COMPONENT__FREQUENCY),
+        .amplitude = tm_the_truth_api->get_float(tt, asset_r, TM_TT_PROP__CUSTOM_COMPONENT__AMPLITUDE),
+        .lod = tm_the_truth_api->get_bool(tt, asset_r, TM_TT_PROP__CUSTOM_COMPONENT__LOD),
+    };
     return true;
 }
 
+static void component__destroy(tm_component_manager_o* mgr_in)
+{
+    custom_component_manager_t* mgr = (custom_component_manager_t*)mgr_in;
+    tm_allocator_i a = mgr->allocator;
+    tm_entity_context_o* ctx = mgr->ctx;
+    tm_free(&a, mgr, sizeof(*mgr));
+    tm_entity_api->destroy_child_allocator(ctx, &a);
+}
+
 static void component__create(struct tm_entity_context_o* ctx)
 {
+    tm_allocator_i a;
+    tm_entity_api->create_child_allocator(ctx, TM_TT_TYPE__CUSTOM_COMPONENT, &a);
+    custom_component_manager_t* m = tm_alloc(&a, sizeof(*m));
+    *m = (custom_component_manager_t){
+        .allocator = a,
+        .ctx = ctx,
+    };
+
     tm_component_i component = {
         .name = TM_TT_TYPE__CUSTOM_COMPONENT,
         .bytes = sizeof(struct tm_custom_component_t),
         .load_asset = component__load_asset,
+        .destroy = component__destroy,
+        .manager = (tm_component_manager_o*)m,
     };
 
     tm_entity_api->register_component(ctx, &component);
 }
 
+// Bobbing motion of the custom component: y = y0 + amplitude * sin(t * frequency). The scalar and SIMD paths
+// use the same range reduction and polynomial, so entities move the same (up to rounding) whichever path a
+// build uses. The sine is accurate to about 4e-6.
+
+#define BOB__INV_TWO_PI 0.15915494f
+#define BOB__TWO_PI_HI 6.28125f
+#define BOB__TWO_PI_LO 1.9353072e-3f
+#define BOB__PI 3.14159265f
+#define BOB__HALF_PI 1.57079633f
+#define BOB__C3 -1.6666667e-1f
+#define BOB__C5 8.3333333e-3f
+#define BOB__C7 -1.9841270e-4f
+#define BOB__C9 2.7557319e-6f
+
+static inline float bob__sin(float x)
+{
+    // Reduce to [-pi, pi], then fold to [-pi/2, pi/2] using sin(x) = sin(+-pi - x).
+    const float k = roundf(x * BOB__INV_TWO_PI);
+    x = (x - k * BOB__TWO_PI_HI) - k * BOB__TWO_PI_LO;
+    if (x > BOB__HALF_PI)
+        x = BOB__PI - x;
+    else if (x < -BOB__HALF_PI)
+        x = -BOB__PI - x;
+
+    const float x2 = x * x;
+    return x + x * x2 * (BOB__C3 + x2 * (BOB__C5 + x2 * (BOB__C7 + x2 * BOB__C9)));
+}
+
+// Computes `y[i]` for `i` in [`begin`, `end`).
+static void bob__update_scalar(float* y, const float* y0, const float* frequency, const float* amplitude, float t, uint32_t begin, uint32_t end)
+{
+    for (uint32_t i = begin; i < end; ++i)
+        y[i] = y0[i] + amplitude[i] * bob__sin(t * frequency[i]);
+}
+
+#if defined(__AVX__)
+
+#define BOB__WIDTH 8
+
+static inline __m256 bob__sin_avx(__m256 x)
+{
+    const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+    const __m256 k = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(BOB__INV_TWO_PI)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    x = _mm256_sub_ps(_mm256_sub_ps(x, _mm256_mul_ps(k, _mm256_set1_ps(BOB__TWO_PI_HI))), _mm256_mul_ps(k, _mm256_set1_ps(BOB__TWO_PI_LO)));
+
+    const __m256 pi_with_sign_of_x = _mm256_or_ps(_mm256_set1_ps(BOB__PI), _mm256_and_ps(x, sign_mask));
+    const __m256 fold = _mm256_cmp_ps(_mm256_andnot_ps(sign_mask, x), _mm256_set1_ps(BOB__HALF_PI), _CMP_GT_OQ);
+    x = _mm256_blendv_ps(x, _mm256_sub_ps(pi_with_sign_of_x, x), fold);
+
+    const __m256 x2 = _mm256_mul_ps(x, x);
+    __m256 p = _mm256_add_ps(_mm256_set1_ps(BOB__C7), _mm256_mul_ps(x2, _mm256_set1_ps(BOB__C9)));
+    p = _mm256_add_ps(_mm256_set1_ps(BOB__C5), _mm256_mul_ps(x2, p));
+    p = _mm256_add_ps(_mm256_set1_ps(BOB__C3), _mm256_mul_ps(x2, p));
+    return _mm256_add_ps(x, _mm256_mul_ps(_mm256_mul_ps(x, x2), p));
+}
+
+// Computes `y[i]` for `i` in [0, `n`), where `n` is a multiple of `BOB__WIDTH`.
+static void bob__update_simd(float* y, const float* y0, const float* frequency, const float* amplitude, float t, uint32_t n)
+{
+    const __m256 t_v = _mm256_set1_ps(t);
+    for (uint32_t i = 0; i < n; i += BOB__WIDTH) {
+        const __m256 s = bob__sin_avx(_mm256_mul_ps(t_v, _mm256_loadu_ps(frequency + i)));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y0 + i), _mm256_mul_ps(_mm256_loadu_ps(amplitude + i), s)));
+    }
+}
+
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+#define BOB__WIDTH 4
+
+static inline __m128 bob__sin_sse2(__m128 x)
+{
+    const __m128 sign_mask = _mm_set1_ps(-0.0f);
+    const __m128 k = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(BOB__INV_TWO_PI))));
+    x = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(BOB__TWO_PI_HI))), _mm_mul_ps(k, _mm_set1_ps(BOB__TWO_PI_LO)));
+
+    const __m128 pi_with_sign_of_x = _mm_or_ps(_mm_set1_ps(BOB__PI), _mm_and_ps(x, sign_mask));
+    const __m128 fold = _mm_cmpgt_ps(_mm_andnot_ps(sign_mask, x), _mm_set1_ps(BOB__HALF_PI));
+    x = _mm_or_ps(_mm_and_ps(fold, _mm_sub_ps(pi_with_sign_of_x, x)), _mm_andnot_ps(fold, x));
+
+    const __m128 x2 = _mm_mul_ps(x, x);
+    __m128 p = _mm_add_ps(_mm_set1_ps(BOB__C7), _mm_mul_ps(x2, _mm_set1_ps(BOB__C9)));
+    p = _mm_add_ps(_mm_set1_ps(BOB__C5), _mm_mul_ps(x2, p));
+    p = _mm_add_ps(_mm_set1_ps(BOB__C3), _mm_mul_ps(x2, p));
+    return _mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(x, x2), p));
+}
+
+// Computes `y[i]` for `i` in [0, `n`), where `n` is a multiple of `BOB__WIDTH`.
+static void bob__update_simd(float* y, const float* y0, const float* frequency, const float* amplitude, float t, uint32_t n)
+{
+    const __m128 t_v = _mm_set1_ps(t);
+    for (uint32_t i = 0; i < n; i += BOB__WIDTH) {
+        const __m128 s = bob__sin_sse2(_mm_mul_ps(t_v, _mm_loadu_ps(frequency + i)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y0 + i), _mm_mul_ps(_mm_loadu_ps(amplitude + i), s)));
+    }
+}
+
+#endif
+
+// Computes `y[i] = y0[i] + amplitude[i] * sin(t * frequency[i])` for `i` in [0, `n`). Runs `BOB__WIDTH`
+// entities at a time when built with SSE2 or AVX and does the rest with scalar code.
+static void bob__update(float* y, const float* y0, const float* frequency, const float* amplitude, float t, uint32_t n)
+{
+    uint32_t num_simd = 0;
+#if defined(BOB__WIDTH)
+    num_simd = n - n % BOB__WIDTH;
+    bob__update_simd(y, y0, frequency, amplitude, t, num_simd);
+#endif
+    bob__update_scalar(y, y0, frequency, amplitude, t, num_simd, n);
+}
+
+// Number of entities updated by each job of the custom component engine.
+#define CUSTOM_JOB_SIZE 16384u
+
+// Entities with `lod` set that are further than this from the camera are updated `CUSTOM_LOD_RATE` times per
+// second rather than every frame.
+#define CUSTOM_LOD_DISTANCE 50.0f
+#define CUSTOM_LOD_RATE 10.0
+
+// Entities with `lod` set that are further than this from the camera are not updated until they come closer
+// again. Since the motion only depends on the time, they are in the right place as soon as they are updated
+// again.
+#define CUSTOM_CULL_DISTANCE 200.0f
+
+// A range of entities in one update array, updated by one job.
+typedef struct custom_job_t {
+    tm_engine_update_array_t* array;
+    uint32_t first;
+    uint32_t count;
+    double t;
+    double dt;
+
+    // Set if entities with `lod` set are skipped or updated less often based on their distance to
+    // `camera_pos`.
+    bool lod;
+
+    // Set by the job if any of its entities has `lod` set.
+    bool saw_lod;
+    TM_PAD(2);
+    tm_vec3_t camera_pos;
+
+    // If `lod` is set, the job writes the entities it updated here, `num_modified` of them. Otherwise all
+    // `count` entities are updated.
+    tm_entity_t* modified;
+    uint32_t num_modified;
+    TM_PAD(4);
+} custom_job_t;
+
+// Returns true if the entity `c` should be updated this frame. `stagger` spreads the updates of distant
+// entities over different frames. It comes from the entity handle rather than the position in the array, so
+// an entity keeps its update frames when entities are added to or removed from the array.
+static inline bool custom__is_relevant(const custom_job_t* job, const struct tm_custom_component_t* c, uint32_t stagger)
+{
+    if (!job->lod || !c->lod)
+        return true;
+
+    const tm_vec3_t d = tm_vec3_sub(c->origin, job->camera_pos);
+    const float dist_sq = tm_vec3_dot(d, d);
+    if (dist_sq > CUSTOM_CULL_DISTANCE * CUSTOM_CULL_DISTANCE)
+        return false;
+    if (dist_sq <= CUSTOM_LOD_DISTANCE * CUSTOM_LOD_DISTANCE)
+        return true;
+
+    // Update if a tick of a `CUSTOM_LOD_RATE` clock, offset per entity, happened during this frame.
+    const double offset = (double)(stagger % 64) / 64.0;
+    return floor(job->t * CUSTOM_LOD_RATE + offset) != floor((job->t - job->dt) * CUSTOM_LOD_RATE + offset);
+}
+
+// Number of entities handled at a time by `custom_job__update()`.
+#define CUSTOM_SOA_BLOCK 256u
+
+static void custom_job__update(void* data)
+{
+    custom_job_t* job = data;
+    struct tm_custom_component_t* custom = (struct tm_custom_component_t*)job->array->components[0] + job->first;
+    tm_transform_component_t* transform = (tm_transform_component_t*)job->array->components[1] + job->first;
+    const tm_entity_t* entities = job->array->entities + job->first;
+
+    // SoA copy of the bobbing entities of a block, on the stack so that the update needs no allocations.
+    uint32_t bob_idx[CUSTOM_SOA_BLOCK];
+    float y0[CUSTOM_SOA_BLOCK];
+    float frequency[CUSTOM_SOA_BLOCK];
+    float amplitude[CUSTOM_SOA_BLOCK];
+    float y[CUSTOM_SOA_BLOCK];
+
+    bool saw_lod = false;
+    job->num_modified = 0;
+    for (uint32_t first = 0; first < job->count; first += CUSTOM_SOA_BLOCK) {
+        const uint32_t end = first + tm_min(CUSTOM_SOA_BLOCK, job->count - first);
+        const uint32_t n = end - first;
+
+        // Fast path: if every entity in the block bobs and is updated this frame, the block goes straight
+        // through `bob__update()`, without checking the motion and distance of each entity.
+        uint32_t num_bob = 0;
+        for (uint32_t i = first; i < end; ++i) {
+            const struct tm_custom_component_t* c = custom + i;
+            if (c->motion != CUSTOM_MOTION__BOB || !c->has_origin || (c->lod && job->lod))
+                break;
+            saw_lod |= c->lod;
+            y0[num_bob] = c->origin.y;
+            frequency[num_bob] = c->frequency;
+            amplitude[num_bob] = c->amplitude;
+            ++num_bob;
+        }
+
+        if (num_bob == n) {
+            bob__update(y, y0, frequency, amplitude, (float)job->t, n);
+            for (uint32_t i = 0; i < n; ++i) {
+                tm_transform_component_t* tr = transform + first + i;
+                tr->world.pos.y = y[i];
+                ++tr->version;
+            }
+            if (job->modified) {
+                for (uint32_t i = first; i < end; ++i)
+                    job->modified[job->num_modified++] = entities[i];
+            } else {
+                job->num_modified += n;
+            }
+            continue;
+        }
+
+        num_bob = 0;
+        for (uint32_t i = first; i < end; ++i) {
+            struct tm_custom_component_t* c = custom + i;
+            tm_transform_component_t* tr = transform + i;
+
+            if (!c->has_origin) {
+                c->origin = tr->world.pos;
+                c->origin_rot = tr->world.rot;
+                c->has_origin = true;
+            }
+
+            saw_lod |= c->lod;
+            if (!custom__is_relevant(job, c, (uint32_t)entities[i].u64))
+                continue;
+
+            const double angle = job->t * c->frequency;
+            switch (c->motion) {
+            case CUSTOM_MOTION__BOB:
+                bob_idx[num_bob] = i;
+                y0[num_bob] = c->origin.y;
+                frequency[num_bob] = c->frequency;
+                amplitude[num_bob] = c->amplitude;
+                ++num_bob;
+                break;
+            case CUSTOM_MOTION__ROTATE:
+                tr->world.rot = tm_quaternion_mul(c->origin_rot, tm_quaternion_from_rotation((tm_vec3_t){ 0, 1, 0 }, (float)fmod(angle, 2 * TM_PI)));
+                break;
+            case CUSTOM_MOTION__ORBIT:
+                tr->world.pos = tm_vec3_add(c->origin, (tm_vec3_t){ c->amplitude * (float)cos(angle), 0, c->amplitude * (float)sin(angle) });
+                break;
+            case CUSTOM_MOTION__PING_PONG: {
+                const double phase = angle / (2 * TM_PI);
+                const float triangle = 1.0f - fabsf(1.0f - 2.0f * (float)(phase - floor(phase)));
+                tr->world.pos.x = c->origin.x + c->amplitude * triangle;
+            } break;
+            }
+
+            ++tr->version;
+            if (job->modified)
+                job->modified[job->num_modified] = entities[i];
+            ++job->num_modified;
+        }
+
+        bob__update(y, y0, frequency, amplitude, (float)job->t, num_bob);
+        for (uint32_t i = 0; i < num_bob; ++i)
+            transform[bob_idx[i]].world.pos.y = y[i];
+    }
+    job->saw_lod = saw_lod;
+}
+
 // Runs on (custom_component, transform_component)
 static void engine_update__custom(tm_engine_o* inst, tm_engine_update_set_t* data,struct tm_entity_commands_o *commands)
 {
     TM_INIT_TEMP_ALLOCATOR(ta);
 
-    tm_entity_t* mod_transform = 0;
+    custom_component_manager_t* mgr = (custom_component_manager_t*)inst;
+    struct tm_entity_context_o* ctx = mgr->ctx;
 
-    struct tm_entity_context_o* ctx = (struct tm_entity_context_o*)inst;
+    const double t = blackboard_cache_double(&mgr->blackboard, data, CUSTOM_BB__TIME, 0);
+    const double dt = blackboard_cache_double(&mgr->blackboard, data, CUSTOM_BB__DELTA_TIME, 0);
+    const tm_transform_t* camera = blackboard_cache_ptr(&mgr->blackboard, data, CUSTOM_BB__CAMERA_TRANSFORM);
 
-    double t = 0;
-    for (const tm_entity_blackboard_value_t* bb = data->blackboard_start; bb != data->blackboard_end; ++bb) {
-        if (TM_STRHASH_U64(bb->id) == TM_STRHASH_U64(TM_ENTITY_BB__TIME))
-            t = bb->double_value;
+    // Without a camera, or if no entity had `lod` set in the last update, every entity is updated every frame.
+    // An entity with `lod` set is thus updated every frame until the update after the one that first sees it.
+    const bool lod = camera && dt > 0 && mgr->lod_used;
+
+    // Split the update arrays into jobs of at most `CUSTOM_JOB_SIZE` entities.
+    uint32_t num_entities = 0;
+    uint32_t num_jobs = 0;
+    for (const tm_engine_update_array_t* a = data->arrays; a < data->arrays + data->num_arrays; ++a) {
+        num_entities += a->n;
+        num_jobs += (a->n + CUSTOM_JOB_SIZE - 1) / CUSTOM_JOB_SIZE;
     }
 
-    for (tm_engine_update_array_t* a = data->arrays; a < data->arrays + data->num_arrays; ++a) {
-        struct tm_custom_component_t* custom = a->components[0];
-        tm_transform_component_t* transform = a->components[1];
+    custom_job_t* jobs = 0;
+    tm_carray_temp_resize(jobs, num_jobs, ta);
 
-        for (uint32_t i = 0; i < a->n; ++i) {
-            if (!custom[i].y0)
-                custom[i].y0 = transform[i].world.pos.y;
-            const float y = custom[i].y0 + custom[i].amplitude * sinf((float)t * custom[i].frequency);
+    // Only needed if some entities may be skipped, otherwise the ranges of the jobs in the update arrays list the
+    // modified entities.
+    tm_entity_t* modified = 0;
+    if (lod)
+        tm_carray_temp_resize(modified, num_entities, ta);
 
-            transform[i].world.pos.y = y;
-            ++transform[i].version;
-            tm_carray_temp_push(mod_transform, a->entities[i], ta);
+    uint32_t job_idx = 0;
+    uint32_t num_assigned = 0;
+    for (tm_engine_update_array_t* a = data->arrays; a < data->arrays + data->num_arrays; ++a) {
+        for (uint32_t first = 0; first < a->n; first += CUSTOM_JOB_SIZE) {
+            const uint32_t count = tm_min(CUSTOM_JOB_SIZE, a->n - first);
+            jobs[job_idx++] = (custom_job_t){
+                .array = a,
+                .first = first,
+                .count = count,
+                .t = t,
+                .dt = dt,
+                .lod = lod,
+                .camera_pos = lod ? camera->pos : (tm_vec3_t){ 0 },
+                .modified = lod ? modified + num_assigned : 0,
+            };
+            num_assigned += count;
         }
     }
 
-    tm_entity_api->notify(ctx, data->engine->components[1], mod_transform, (uint32_t)tm_carray_size(mod_transform));
+    // A single job is run right away, rather than paying for a round trip through the job system.
+    if (num_jobs == 1) {
+        custom_job__update(jobs);
+    } else if (num_jobs > 1) {
+        tm_jobdecl_t* decls = 0;
+        tm_carray_temp_resize(decls, num_jobs, ta);
+        for (uint32_t i = 0; i < num_jobs; ++i)
+            decls[i] = (tm_jobdecl_t){ .task = custom_job__update, .data = jobs + i };
+
+        tm_atomic_counter_o* counter = tm_job_system_api->run_jobs(decls, num_jobs);
+        tm_job_system_api->wait_for_counter_and_free(counter);
+    }
+
+    // If a job updated all its entities, its range of the update array is the list of modified transforms.
+    mgr->lod_used = false;
+    for (const custom_job_t* job = jobs; job != jobs + num_jobs; ++job) {
+        mgr->lod_used |= job->saw_lod;
+        if (job->num_modified == job->count)
+            tm_entity_api->notify(ctx, data->engine->components[1], job->array->entities + job->first, job->count);
+        else if (job->num_modified)
+            tm_entity_api->notify(ctx, data->engine->components[1], job->modified, job->num_modified);
+    }
 
     TM_SHUTDOWN_TEMP_ALLOCATOR(ta);
 }
@@ -116,16 +571,24 @@ static void component__register_engine(struct tm_entity_context_o* ctx)
 {
     const tm_component_type_t custom_component = tm_entity_api->lookup_component_type(ctx, TM_TT_TYPE_HASH__CUSTOM_COMPONENT);
     const tm_component_type_t transform_component = tm_entity_api->lookup_component_type(ctx, TM_TT_TYPE_HASH__TRANSFORM_COMPONENT);
+    custom_component_manager_t* mgr = (custom_component_manager_t*)tm_entity_api->component_manager(ctx, custom_component);
+
+    const tm_strhash_t blackboard_keys[CUSTOM_BB__COUNT] = {
+        [CUSTOM_BB__TIME] = TM_ENTITY_BB__TIME,
+        [CUSTOM_BB__DELTA_TIME] = TM_ENTITY_BB__DELTA_TIME,
+        [CUSTOM_BB__CAMERA_TRANSFORM] = TM_ENTITY_BB__CAMERA_TRANSFORM,
+    };
+    blackboard_cache_init(&mgr->blackboard, blackboard_keys, CUSTOM_BB__COUNT);
 
     const tm_engine_i custom_engine = {
         .ui_name = "Custom Component",
         .hash = TM_STATIC_HASH("TM_ENGINE__CUSTOM_COMPONENT", 0x8e8316d05d37167eULL),
         .num_components = 2,
         .components = { custom_component, transform_component },
-        .writes = { false, true },
+        .writes = { true, true },
         .update = engine_update__custom,
         .filter = engine_filter__custom,
-        .inst = (tm_engine_o*)ctx,
+        .inst = (tm_engine_o*)mgr,
     };
     tm_entity_api->register_engine(ctx, &custom_engine);
 }
@@ -137,6 +600,9 @@ TM_DLL_EXPORT void tm_load_plugin(struct tm_api_registry_api* reg, bool load)
     tm_the_truth_api = tm_get_api(reg, tm_the_truth_api);
     tm_temp_allocator_api = tm_get_api(reg, tm_temp_allocator_api);
     tm_localizer_api = tm_get_api(reg, tm_localizer_api);
+    tm_job_system_api = tm_get_api(reg, tm_job_system_api);
+    tm_properties_view_api = tm_get_api(reg, tm_properties_view_api);
+    tm_ui_api = tm_get_api(reg, tm_ui_api);
 
     tm_add_or_remove_implementation(reg, load, tm_the_truth_create_types_i, truth__create_types);
     tm_add_or_remove_implementation(reg, load, tm_entity_create_component_i, component__create);
@@ -21,6 +21,9 @@ static struct tm_ui_api *tm_ui_api;
 static struct tm_gamestate_api *tm_gamestate_api;
 static struct tm_creation_graph_api *tm_creation_graph_api;
 static struct tm_simulation_gamestate_api* tm_simulation_gamestate_api;
+static struct tm_logger_api *tm_logger_api;
+static struct tm_os_api *tm_os_api;
+static struct tm_profiler_api *tm_profiler_api;
 
 #include <foundation/allocator.h>
 #include <foundation/api_registry.h>
@@ -28,8 +31,11 @@ static struct tm_simulation_gamestate_api* tm_simulation_gamestate_api;
 #include <foundation/error.h>
 #include <foundation/input.h>
 #include <foundation/localizer.h>
+#include <foundation/log.h>
 #include <foundation/macros.h>
 #include <foundation/murmurhash64a.inl>
+#include <foundation/os.h>
+#include <foundation/profiler.h>
 #include <foundation/random.h>
 #include <foundation/the_truth.h>
 #include <foundation/the_truth_assets.h>
@@ -56,23 +62,81 @@ static struct tm_simulation_gamestate_api* tm_simulation_gamestate_api;
 #include <plugins/ui/ui.h>
 
 #include <foundation/carray.inl>
+#include <foundation/hash.inl>
 #include <foundation/math.inl>
 
+#include "../shared/input_state.inl"
+#include "../shared/input_recorder.inl"
+#include "../shared/raycast_batch.inl"
+#include "../shared/random.inl"
+
 #include <stddef.h>
 #include <stdio.h>
 
-static const tm_strhash_t red_tag = TM_STATIC_HASH("color_red", 0xb56d0d7b72d5e8f2ULL);
-static const tm_strhash_t green_tag = TM_STATIC_HASH("color_green", 0x3f94cb7d4091d93bULL);
-static const tm_strhash_t blue_tag = TM_STATIC_HASH("color_blue", 0xbe7fd3918560dcddULL);
+// Color tags, indexed by `box_color`. These are also the tags kept track of by the tag cache, the bit of
+// `color_tags[i]` in a tag mask is `1 << i`.
+static const tm_strhash_t color_tags[] = {
+    TM_STATIC_HASH("color_red", 0xb56d0d7b72d5e8f2ULL),
+    TM_STATIC_HASH("color_green", 0x3f94cb7d4091d93bULL),
+    TM_STATIC_HASH("color_blue", 0xbe7fd3918560dcddULL),
+};
+
+#define NUM_COLORS TM_ARRAY_COUNT(color_tags)
+#define ALL_COLORS_MASK ((1u << NUM_COLORS) - 1)
+
+// Tag changes to an entity that haven't been sent to the tag component manager yet.
+typedef struct tag_mutation_t
+{
+    tm_entity_t entity;
+    uint32_t add;
+    uint32_t remove;
+} tag_mutation_t;
+
+// Caches which of the `color_tags` entities have, as one bitmask per entity. The mask of an entity is
+// read from the tag component manager the first time it is asked for. Changes are applied to the cache
+// right away and sent to the tag component manager by `tag_cache_flush()`, coalesced per entity.
+//
+// Only this sample queries and changes tags while simulating. The third person and interaction samples
+// only use `find_first()` once in `start()`, so they have nothing to cache.
+typedef struct tag_cache_t
+{
+    tm_tag_component_manager_o *tag_mgr;
+    tm_allocator_i *allocator;
+    struct TM_HASH_T(uint64_t, uint32_t) masks;
+
+    // Pending changes. `pending_lookup` maps an entity to its index in `pending`.
+    tag_mutation_t *pending;
+    struct TM_HASH_T(uint64_t, uint32_t) pending_lookup;
+} tag_cache_t;
+
+// Range of `contact_others` that holds the entities touching one entity.
+typedef struct contact_bucket_t
+{
+    uint32_t first;
+    uint32_t count;
+} contact_bucket_t;
 
-typedef struct input_state_t
+// Player actions, mapped to keys by `action_keys`.
+enum action
 {
-    bool held_keys[TM_INPUT_KEYBOARD_ITEM_COUNT];
-    bool left_mouse_held;
-    bool left_mouse_pressed;
-    TM_PAD(1);
-    tm_vec2_t mouse_delta;
-} input_state_t;
+    ACTION_LEFT,
+    ACTION_RIGHT,
+    ACTION_FORWARD,
+    ACTION_BACK,
+    ACTION_JUMP,
+    ACTION_COUNT,
+};
+
+static const uint32_t action_keys[] = {
+    [ACTION_LEFT] = TM_INPUT_KEYBOARD_ITEM_A,
+    [ACTION_RIGHT] = TM_INPUT_KEYBOARD_ITEM_D,
+    [ACTION_FORWARD] = TM_INPUT_KEYBOARD_ITEM_W,
+    [ACTION_BACK] = TM_INPUT_KEYBOARD_ITEM_S,
+    [ACTION_JUMP] = TM_INPUT_KEYBOARD_ITEM_SPACE,
+};
+
+// Where the Record and Replay simulation entries write and read the input recording.
+#define INPUT_RECORDING_PATH "gameplay_sample_first_person.input"
 
 enum box_state
 {
@@ -82,6 +146,101 @@ enum box_state
     BOX_STATE_FLYING_BACK
 };
 
+// What an agent wants to do this frame, from player input or a bot.
+typedef struct agent_controls_t
+{
+    // Bitmask of `enum action`.
+    uint32_t actions;
+
+    // Set if the interact button (left mouse) was pressed this frame.
+    bool interact;
+    TM_PAD(3);
+
+    // Change of yaw and pitch, in radians.
+    tm_vec2_t look_delta;
+} agent_controls_t;
+
+// The players and their boxes, with one array per field. Agent 0 is the local player, which is controlled by
+// input and renders through `camera`. The other agents are bots, spawned by the stress test entry. Bots have
+// no camera, they look from `eye_offset` above their player entity.
+typedef struct agents_t
+{
+    // Entities
+    tm_entity_t *player;
+    tm_entity_t *camera;
+    tm_entity_t *carry_anchor;
+    tm_entity_t *box;
+    tm_vec3_t *box_starting_point;
+    tm_vec4_t *box_starting_rot;
+
+    // How the agent currently is/may interact with its box
+    enum box_state *box_state;
+
+    uint32_t *box_color;
+
+    // Used to decide when to move box from BOX_STATE_FLYING_UP to BOX_STATE_FLYING_BACK
+    float *box_fly_timer;
+
+    // Current camera state
+    float *look_yaw;
+    float *look_pitch;
+    tm_vec4_t *look_rot;
+
+    // Current score
+    float *score;
+
+    // Color and entity that the box material currently is bound for, see `update_box_material()`.
+    uint32_t *bound_box_color;
+    tm_entity_t *bound_box;
+
+    // Set if the agent is looking at its box and can pick it up.
+    bool *box_interactable;
+
+    // Index of this frame's ray from the agent's view in `rays`, or UINT32_MAX if it has none. Only agents
+    // with a free box outside the drop zone of its color need one.
+    uint32_t *box_probe;
+
+    // Controls of this frame and the view they were applied from.
+    agent_controls_t *controls;
+    tm_vec3_t *view_pos;
+    tm_vec4_t *view_rot;
+    tm_vec3_t *anchor_pos;
+
+    // Bots keep doing `bot_actions` and turning at `bot_turn_speed` until `bot_timer` runs out.
+    float *bot_timer;
+    float *bot_turn_speed;
+    uint32_t *bot_actions;
+} agents_t;
+
+// Parts of `tick()` that are timed separately, for the stress test.
+enum tick_phase
+{
+    TICK_PHASE_CONTROLS,
+    TICK_PHASE_MOVEMENT,
+    TICK_PHASE_MATERIALS,
+    TICK_PHASE_CONTACTS,
+    TICK_PHASE_PROBES,
+    TICK_PHASE_BOXES,
+    TICK_PHASE_TAGS,
+    TICK_PHASE_COUNT,
+};
+
+static const char *tick_phase_names[TICK_PHASE_COUNT] = {
+    [TICK_PHASE_CONTROLS] = "controls",
+    [TICK_PHASE_MOVEMENT] = "movement",
+    [TICK_PHASE_MATERIALS] = "materials",
+    [TICK_PHASE_CONTACTS] = "contacts",
+    [TICK_PHASE_PROBES] = "probes",
+    [TICK_PHASE_BOXES] = "boxes",
+    [TICK_PHASE_TAGS] = "tags",
+};
+
+// Number of agents the stress test runs with, one stage after the other.
+static const uint32_t stress_agent_counts[] = {1, 100, 1000};
+
+// Number of ticks each stage of the stress test runs for.
+#define STRESS_TICKS_PER_STAGE 600
+
 struct tm_simulation_state_o
 {
     tm_allocator_i *allocator;
@@ -101,32 +260,50 @@ struct tm_simulation_state_o
     // Contains keyboard and mouse input state.
     input_state_t input;
 
-    // Entities
-    tm_entity_t player;
-    tm_entity_t player_camera;
-    tm_entity_t player_carry_anchor;
-    tm_entity_t box;
-    tm_vec3_t box_starting_point;
-    tm_vec4_t box_starting_rot;
-
-    // How we currently are/may interact with the box
-    enum box_state box_state;
+    // Records or replays the input, see the Record and Replay simulation entries.
+    input_recorder_t recorder;
 
-    uint32_t box_color;
+    // State of the random number generator used by gameplay. Seeded from the recording when replaying, so
+    // that the box gets the same colors.
+    uint64_t random_state;
 
-    // Used to decide when to move box from BOX_STATE_FLYING_UP to BOX_STATE_FLYING_BACK
-    float box_fly_timer;
+    // All agents, see `agents_t`.
+    agents_t agents;
+    uint32_t num_agents;
 
-    // Current camera state
-    float look_yaw;
-    float look_pitch;
+    // Agents from this index on are controlled by bots. 1 normally, 0 in the stress test.
+    uint32_t first_bot;
 
-    // Current score
-    float score;
+    // Offset from the player entity to the camera, used as the eye position of bots.
+    tm_vec3_t eye_offset;
     TM_PAD(4);
 
+    // Box materials, indexed by `box_color`. Looked up once in `start()`.
+    tm_tt_id_t box_materials[3];
+
+    // Contacts of this frame, indexed by entity. `contact_lookup` maps an entity to a bucket in
+    // `contact_buckets`, which points out the range of `contact_others` holding the entities it touches.
+    // Rebuilt once per tick by `build_contact_index()`.
+    contact_bucket_t *contact_buckets;
+    tm_entity_t *contact_others;
+    struct TM_HASH_T(uint64_t, uint32_t) contact_lookup;
+
+    // Color tags of the entities we have looked at.
+    tag_cache_t tags;
+
+    // Raycasts of this frame, see `agents_t.box_probe`.
+    raycast_batch_t rays;
+
+    // Time spent in each `enum tick_phase`, since the last reset.
+    double phase_seconds[TICK_PHASE_COUNT];
+
+    // Stress test progress: index into `stress_agent_counts`, ticks run in the current stage and the time
+    // they took.
+    uint32_t stress_stage;
+    uint32_t stress_ticks;
+    double stress_seconds;
+
     // Misc
-    uint64_t processed_events;
     tm_tt_id_t player_collision_type;
     tm_tt_id_t box_collision_type;
 
@@ -143,10 +320,72 @@ struct tm_simulation_state_o
     tm_tag_component_manager_o *tag_mgr;
 
     bool mouse_captured;
-    bool box_interactable;
-    TM_PAD(6);
+    TM_PAD(7);
 };
 
+// Adds an agent with the given entities and returns its index.
+static uint32_t push_agent(tm_simulation_state_o *state, tm_entity_t player, tm_entity_t camera, tm_entity_t carry_anchor, tm_entity_t box, tm_vec3_t box_starting_point, tm_vec4_t box_starting_rot)
+{
+    agents_t *ag = &state->agents;
+    tm_allocator_i *a = state->allocator;
+
+    tm_carray_push(ag->player, player, a);
+    tm_carray_push(ag->camera, camera, a);
+    tm_carray_push(ag->carry_anchor, carry_anchor, a);
+    tm_carray_push(ag->box, box, a);
+    tm_carray_push(ag->box_starting_point, box_starting_point, a);
+    tm_carray_push(ag->box_starting_rot, box_starting_rot, a);
+    tm_carray_push(ag->box_state, BOX_STATE_FREE, a);
+    tm_carray_push(ag->box_color, 0, a);
+    tm_carray_push(ag->box_fly_timer, 0.0f, a);
+    tm_carray_push(ag->look_yaw, 0.0f, a);
+    tm_carray_push(ag->look_pitch, 0.0f, a);
+    tm_carray_push(ag->look_rot, ((tm_vec4_t){0, 0, 0, 1}), a);
+    tm_carray_push(ag->score, 0.0f, a);
+    tm_carray_push(ag->bound_box_color, UINT32_MAX, a);
+    tm_carray_push(ag->bound_box, (tm_entity_t){0}, a);
+    tm_carray_push(ag->box_interactable, false, a);
+    tm_carray_push(ag->box_probe, UINT32_MAX, a);
+    tm_carray_push(ag->controls, (agent_controls_t){0}, a);
+    tm_carray_push(ag->view_pos, (tm_vec3_t){0}, a);
+    tm_carray_push(ag->view_rot, ((tm_vec4_t){0, 0, 0, 1}), a);
+    tm_carray_push(ag->anchor_pos, (tm_vec3_t){0}, a);
+    tm_carray_push(ag->bot_timer, 0.0f, a);
+    tm_carray_push(ag->bot_turn_speed, 0.0f, a);
+    tm_carray_push(ag->bot_actions, 0, a);
+
+    return state->num_agents++;
+}
+
+static void free_agents(agents_t *ag, tm_allocator_i *a)
+{
+    tm_carray_free(ag->player, a);
+    tm_carray_free(ag->camera, a);
+    tm_carray_free(ag->carry_anchor, a);
+    tm_carray_free(ag->box, a);
+    tm_carray_free(ag->box_starting_point, a);
+    tm_carray_free(ag->box_starting_rot, a);
+    tm_carray_free(ag->box_state, a);
+    tm_carray_free(ag->box_color, a);
+    tm_carray_free(ag->box_fly_timer, a);
+    tm_carray_free(ag->look_yaw, a);
+    tm_carray_free(ag->look_pitch, a);
+    tm_carray_free(ag->look_rot, a);
+    tm_carray_free(ag->score, a);
+    tm_carray_free(ag->bound_box_color, a);
+    tm_carray_free(ag->bound_box, a);
+    tm_carray_free(ag->box_interactable, a);
+    tm_carray_free(ag->box_probe, a);
+    tm_carray_free(ag->controls, a);
+    tm_carray_free(ag->view_pos, a);
+    tm_carray_free(ag->view_rot, a);
+    tm_carray_free(ag->anchor_pos, a);
+    tm_carray_free(ag->bot_timer, a);
+    tm_carray_free(ag->bot_turn_speed, a);
+    tm_carray_free(ag->bot_actions, a);
+}
+
+// Only the local player (agent 0) is part of the gamestate, bots are recreated by the stress test.
 typedef struct simulate_persistent_state
 {
     tm_gamestate_object_id_t player;
@@ -168,152 +407,314 @@ typedef struct simulate_persistent_state
     TM_PAD(4);
 } simulate_persistent_state;
 
+static inline void tag_cache_init(tag_cache_t *tc, tm_tag_component_manager_o *tag_mgr, tm_allocator_i *a)
+{
+    *tc = (tag_cache_t){
+        .tag_mgr = tag_mgr,
+        .allocator = a,
+        .masks = {.allocator = a},
+        .pending_lookup = {.allocator = a},
+    };
+}
+
+static inline void tag_cache_free(tag_cache_t *tc)
+{
+    tm_hash_free(&tc->masks);
+    tm_carray_free(tc->pending, tc->allocator);
+    tm_hash_free(&tc->pending_lookup);
+}
+
+// Returns the tag mask of `e`.
+static inline uint32_t tag_cache_mask(tag_cache_t *tc, tm_entity_t e)
+{
+    const uint32_t cached = tm_hash_get_default(&tc->masks, e.u64, UINT32_MAX);
+    if (cached != UINT32_MAX)
+        return cached;
+
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < NUM_COLORS; ++i)
+    {
+        if (tm_tag_component_api->has_tag(tc->tag_mgr, e, color_tags[i]))
+            mask |= 1u << i;
+    }
+    tm_hash_add(&tc->masks, e.u64, mask);
+    return mask;
+}
+
+// Checks which of the `n` `entities` have any of the tags in `mask`. If `res` is non-NULL, the result for
+// each entity is written to it. Returns the number of entities that have any of the tags.
+static inline uint32_t tag_cache_has_any(tag_cache_t *tc, const tm_entity_t *entities, uint32_t n, uint32_t mask, bool *res)
+{
+    uint32_t num_matching = 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        const bool match = (tag_cache_mask(tc, entities[i]) & mask) != 0;
+        num_matching += match;
+        if (res)
+            res[i] = match;
+    }
+    return num_matching;
+}
+
+// As `tag_cache_has_any()`, but checks if the entities have all of the tags in `mask`.
+static inline uint32_t tag_cache_has_all(tag_cache_t *tc, const tm_entity_t *entities, uint32_t n, uint32_t mask, bool *res)
+{
+    uint32_t num_matching = 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        const bool match = (tag_cache_mask(tc, entities[i]) & mask) == mask;
+        num_matching += match;
+        if (res)
+            res[i] = match;
+    }
+    return num_matching;
+}
+
+// Removes the tags in `remove` from `e` and then adds the tags in `add`.
+static inline void tag_cache_set(tag_cache_t *tc, tm_entity_t e, uint32_t add, uint32_t remove)
+{
+    const uint32_t old_mask = tag_cache_mask(tc, e);
+    const uint32_t new_mask = (old_mask & ~remove) | add;
+    if (new_mask == old_mask)
+        return;
+
+    tm_hash_add(&tc->masks, e.u64, new_mask);
+
+    uint32_t idx = tm_hash_get_default(&tc->pending_lookup, e.u64, UINT32_MAX);
+    if (idx == UINT32_MAX)
+    {
+        idx = (uint32_t)tm_carray_size(tc->pending);
+        tm_hash_add(&tc->pending_lookup, e.u64, idx);
+        tm_carray_push(tc->pending, (tag_mutation_t){.entity = e}, tc->allocator);
+    }
+
+    // Later changes override earlier ones for the same tag.
+    tag_mutation_t *m = tc->pending + idx;
+    m->add = (m->add & ~remove) | add;
+    m->remove = (m->remove & ~add) | remove;
+}
+
+// Sends the pending changes to the tag component manager.
+static inline void tag_cache_flush(tag_cache_t *tc)
+{
+    for (const tag_mutation_t *m = tc->pending; m != tm_carray_end(tc->pending); ++m)
+    {
+        for (uint32_t i = 0; i < NUM_COLORS; ++i)
+        {
+            if (m->remove & (1u << i))
+                tm_tag_component_api->remove_tag(tc->tag_mgr, m->entity, color_tags[i]);
+        }
+        for (uint32_t i = 0; i < NUM_COLORS; ++i)
+        {
+            if (m->add & (1u << i))
+                tm_tag_component_api->add_tag(tc->tag_mgr, m->entity, color_tags[i]);
+        }
+    }
+
+    tm_carray_resize(tc->pending, 0, tc->allocator);
+    tm_hash_clear(&tc->pending_lookup);
+}
+
+// Forgets the cached masks and drops the pending changes, for when the tags have been changed behind the
+// cache's back.
+static inline void tag_cache_reset(tag_cache_t *tc)
+{
+    tm_hash_clear(&tc->masks);
+    tm_carray_resize(tc->pending, 0, tc->allocator);
+    tm_hash_clear(&tc->pending_lookup);
+}
+
 static void serialize(void *s, void *d)
 {
     tm_simulation_state_o *source = (tm_simulation_state_o *)s;
     simulate_persistent_state *dest = (simulate_persistent_state *)d;
+    const agents_t *ag = &source->agents;
     
     struct tm_simulation_gamestate_context_o* gamestate = tm_simulation_api->gamestate_context(source->sim);
-    tm_simulation_gamestate_api->entity_is_persistent(gamestate, source->player, 0, &dest->player, 0);
-    tm_simulation_gamestate_api->entity_is_persistent(gamestate, source->player_camera, 0, &dest->player_camera, 0);
-    tm_simulation_gamestate_api->entity_is_persistent(gamestate, source->player_carry_anchor, 0, &dest->player_carry_anchor, 0);
-    tm_simulation_gamestate_api->entity_is_persistent(gamestate, source->box, 0, &dest->box, 0);
+    tm_simulation_gamestate_api->entity_is_persistent(gamestate, ag->player[0], 0, &dest->player, 0);
+    tm_simulation_gamestate_api->entity_is_persistent(gamestate, ag->camera[0], 0, &dest->player_camera, 0);
+    tm_simulation_gamestate_api->entity_is_persistent(gamestate, ag->carry_anchor[0], 0, &dest->player_carry_anchor, 0);
+    tm_simulation_gamestate_api->entity_is_persistent(gamestate, ag->box[0], 0, &dest->box, 0);
 
-    dest->box_starting_point = source->box_starting_point;
-    dest->box_starting_rot = source->box_starting_rot;
+    dest->box_starting_point = ag->box_starting_point[0];
+    dest->box_starting_rot = ag->box_starting_rot[0];
 
-    dest->box_state = source->box_state;
-    dest->box_color = source->box_color;
-    dest->box_fly_timer = source->box_fly_timer;
+    dest->box_state = ag->box_state[0];
+    dest->box_color = ag->box_color[0];
+    dest->box_fly_timer = ag->box_fly_timer[0];
 
-    dest->look_yaw = source->look_yaw;
-    dest->look_pitch = source->look_pitch;
+    dest->look_yaw = ag->look_yaw[0];
+    dest->look_pitch = ag->look_pitch[0];
 
-    dest->score = source->score;
+    dest->score = ag->score[0];
 }
 
 static void deserialize(void *d, void *s)
 {
     tm_simulation_state_o *dest = (tm_simulation_state_o *)d;
     simulate_persistent_state *source = (simulate_persistent_state *)s;
+    agents_t *ag = &dest->agents;
     
     struct tm_simulation_gamestate_context_o* gamestate = tm_simulation_api->gamestate_context(dest->sim);
     
-    dest->player = tm_simulation_gamestate_api->lookup_entity_from_gamestate_id(gamestate, &source->player);
-    dest->player_camera = tm_simulation_gamestate_api->lookup_entity_from_gamestate_id(gamestate, &source->player_camera);
-    dest->player_carry_anchor = tm_simulation_gamestate_api->lookup_entity_from_gamestate_id(gamestate, &source->player_carry_anchor);
-    dest->box = tm_simulation_gamestate_api->lookup_entity_from_gamestate_id(gamestate, &source->box);
+    ag->player[0] = tm_simulation_gamestate_api->lookup_entity_from_gamestate_id(gamestate, &source->player);
+    ag->camera[0] = tm_simulation_gamestate_api->lookup_entity_from_gamestate_id(gamestate, &source->player_camera);
+    ag->carry_anchor[0] = tm_simulation_gamestate_api->lookup_entity_from_gamestate_id(gamestate, &source->player_carry_anchor);
+    ag->box[0] = tm_simulation_gamestate_api->lookup_entity_from_gamestate_id(gamestate, &source->box);
+
+    ag->box_starting_point[0] = source->box_starting_point;
+    ag->box_starting_rot[0] = source->box_starting_rot;
 
-    dest->box_starting_point = source->box_starting_point;
-    dest->box_starting_rot = source->box_starting_rot;
+    ag->box_state[0] = source->box_state;
+    ag->box_color[0] = source->box_color;
+    ag->box_fly_timer[0] = source->box_fly_timer;
 
-    dest->box_state = source->box_state;
-    dest->box_color = source->box_color;
-    dest->box_fly_timer = source->box_fly_timer;
+    ag->look_yaw[0] = source->look_yaw;
+    ag->look_pitch[0] = source->look_pitch;
 
-    dest->look_yaw = source->look_yaw;
-    dest->look_pitch = source->look_pitch;
+    ag->score[0] = source->score;
 
-    dest->score = source->score;
+    // The gamestate restores the tags and render components of the entities, so neither the tag masks nor
+    // the bound box material can be trusted anymore.
+    tag_cache_reset(&dest->tags);
+    ag->bound_box[0] = (tm_entity_t){0};
+    ag->bound_box_color[0] = UINT32_MAX;
 
-    tm_simulation_api->set_camera(dest->sim, dest->player_camera);
+    tm_simulation_api->set_camera(dest->sim, ag->camera[0]);
 }
 
-static void update_box_material(tm_simulation_state_o *state)
+// Buckets this frame's contact events by entity, so that the contacts of an entity can be found without
+// scanning all events. Each contact is added to the buckets of both actors.
+static void build_contact_index(tm_simulation_state_o *state, const tm_physx_on_contact_t *contacts)
 {
-    tm_entity_t box = state->box;
+    const uint32_t n = (uint32_t)tm_carray_size(contacts);
+    tm_hash_clear(&state->contact_lookup);
+    tm_carray_resize(state->contact_buckets, 0, state->allocator);
+    tm_carray_resize(state->contact_others, 2 * n, state->allocator);
 
-    if (box.u64)
+    for (const tm_physx_on_contact_t *t = contacts; t != tm_carray_end(contacts); ++t)
     {
-        tm_tt_id_t material = (tm_tt_id_t){0};
-
-        switch (state->box_color)
+        const tm_entity_t actors[2] = {t->actor_0, t->actor_1};
+        for (uint32_t i = 0; i < 2; ++i)
         {
-        case 0:
-            material = tm_the_truth_assets_api->asset_object_from_path(state->tt, state->asset_root, "materials/box-red-mat.creation");
-            break;
-        case 1:
-            material = tm_the_truth_assets_api->asset_object_from_path(state->tt, state->asset_root, "materials/box-green-mat.creation");
-            break;
-        case 2:
-            material = tm_the_truth_assets_api->asset_object_from_path(state->tt, state->asset_root, "materials/box-blue-mat.creation");
-            break;
+            uint32_t bucket = tm_hash_get_default(&state->contact_lookup, actors[i].u64, UINT32_MAX);
+            if (bucket == UINT32_MAX)
+            {
+                bucket = (uint32_t)tm_carray_size(state->contact_buckets);
+                tm_hash_add(&state->contact_lookup, actors[i].u64, bucket);
+                tm_carray_push(state->contact_buckets, (contact_bucket_t){0}, state->allocator);
+            }
+            ++state->contact_buckets[bucket].count;
         }
+    }
 
-        const tm_entity_t cube = box;
+    uint32_t first = 0;
+    for (contact_bucket_t *b = state->contact_buckets; b != tm_carray_end(state->contact_buckets); ++b)
+    {
+        b->first = first;
+        first += b->count;
+        b->count = 0;
+    }
 
-        if (!cube.u64)
-            return;
+    for (const tm_physx_on_contact_t *t = contacts; t != tm_carray_end(contacts); ++t)
+    {
+        contact_bucket_t *b0 = state->contact_buckets + tm_hash_get_default(&state->contact_lookup, t->actor_0.u64, 0);
+        state->contact_others[b0->first + b0->count++] = t->actor_1;
+        contact_bucket_t *b1 = state->contact_buckets + tm_hash_get_default(&state->contact_lookup, t->actor_1.u64, 0);
+        state->contact_others[b1->first + b1->count++] = t->actor_0;
+    }
+}
 
-        TM_INIT_TEMP_ALLOCATOR(ta);
-        tm_creation_graph_instance_t **instances = tm_creation_graph_api->get_instances_from_component(state->tt, state->entity_ctx, cube, TM_TT_TYPE_HASH__RENDER_COMPONENT, ta);
-
-        tm_creation_graph_context_t cg_ctx = {
-            .tt = state->tt,
-            .entity_ctx = state->entity_ctx,
-            .ta = ta,
-            .entity_id = box.u64,
-            // NOTE(Leonardo): this isn't passed along anymore in the simulate_entry, but it doesn't seem to be creating
-            // any problem at all if we pass NULL. needs to be investigated to make sure everything's fine here.
-            //.rb = state->render_backend,
-            .device_affinity_mask = TM_RENDERER_DEVICE_AFFINITY_MASK_ALL,
-        };
-
-        tm_resource_reference_t mat = {
-            .creation_graph = material,
-            .node_type_hash = TM_CREATION_GRAPH__SHADER_INSTANCE_OUTPUT_HASH,
-        };
-
-        for (uint32_t instance_idx = 0; instance_idx < tm_carray_size(instances); ++instance_idx)
-        {
-            tm_creation_graph_instance_t *instance = instances[instance_idx];
-            tm_creation_graph_api->set_input_value(instance, &cg_ctx, TM_STATIC_HASH("material", 0xeac0b497876adedfULL), &mat, sizeof(mat));
-        }
+// Returns true if `e` touches an entity that has any of the colors in `mask` this frame.
+static bool touches_color(tm_simulation_state_o *state, tm_entity_t e, uint32_t mask)
+{
+    const uint32_t bucket = tm_hash_get_default(&state->contact_lookup, e.u64, UINT32_MAX);
+    if (!mask || bucket == UINT32_MAX)
+        return false;
 
-        TM_SHUTDOWN_TEMP_ALLOCATOR(ta);
-    }
+    const contact_bucket_t *b = state->contact_buckets + bucket;
+    return tag_cache_has_any(&state->tags, state->contact_others + b->first, b->count, mask, 0) > 0;
 }
 
-static void change_box_to_random_color(tm_simulation_state_o *state)
+// Binds the material of the current box color to the box of agent `i`. Does nothing if it is already bound,
+// so it is cheap to call every frame. If the render component of the box has no creation graph instances
+// yet, the binding is retried next frame.
+static void update_box_material(tm_simulation_state_o *state, uint32_t i)
 {
-    tm_entity_t box = state->box;
+    agents_t *ag = &state->agents;
+    tm_entity_t box = ag->box[i];
+
+    if (!box.u64)
+        return;
+
+    if (box.u64 == ag->bound_box[i].u64 && ag->box_color[i] == ag->bound_box_color[i])
+        return;
+
+    const tm_tt_id_t material = ag->box_color[i] < TM_ARRAY_COUNT(state->box_materials) ? state->box_materials[ag->box_color[i]] : (tm_tt_id_t){0};
+
+    TM_INIT_TEMP_ALLOCATOR(ta);
+    tm_creation_graph_instance_t **instances = tm_creation_graph_api->get_instances_from_component(state->tt, state->entity_ctx, box, TM_TT_TYPE_HASH__RENDER_COMPONENT, ta);
+
+    tm_creation_graph_context_t cg_ctx = {
+        .tt = state->tt,
+        .entity_ctx = state->entity_ctx,
+        .ta = ta,
+        .entity_id = box.u64,
+        // NOTE(Leonardo): this isn't passed along anymore in the simulate_entry, but it doesn't seem to be creating
+        // any problem at all if we pass NULL. needs to be investigated to make sure everything's fine here.
+        //.rb = state->render_backend,
+        .device_affinity_mask = TM_RENDERER_DEVICE_AFFINITY_MASK_ALL,
+    };
 
-    // Chose a random color, but never re-use the current one;
-    uint32_t color = UINT32_MAX;
-    while (color == UINT32_MAX)
+    tm_resource_reference_t mat = {
+        .creation_graph = material,
+        .node_type_hash = TM_CREATION_GRAPH__SHADER_INSTANCE_OUTPUT_HASH,
+    };
+
+    for (uint32_t instance_idx = 0; instance_idx < tm_carray_size(instances); ++instance_idx)
     {
-        const uint32_t c = tm_random_api->next() % 3;
-        const tm_strhash_t c_tag = c == 0 ? red_tag : (c == 1 ? green_tag : blue_tag);
+        tm_creation_graph_instance_t *instance = instances[instance_idx];
+        tm_creation_graph_api->set_input_value(instance, &cg_ctx, TM_STATIC_HASH("material", 0xeac0b497876adedfULL), &mat, sizeof(mat));
+    }
 
-        if (!tm_tag_component_api->has_tag(state->tag_mgr, box, c_tag))
-            color = c;
+    if (tm_carray_size(instances))
+    {
+        ag->bound_box[i] = box;
+        ag->bound_box_color[i] = ag->box_color[i];
     }
 
-    state->box_color = color;
+    TM_SHUTDOWN_TEMP_ALLOCATOR(ta);
+}
+
+static void change_box_to_random_color(tm_simulation_state_o *state, uint32_t i)
+{
+    tm_entity_t box = state->agents.box[i];
 
-    tm_strhash_t tag = TM_STRHASH(0);
-    switch (color)
+    // Chose a random color, but never re-use the current one. Pick the n:th of the colors the box doesn't
+    // have, rather than retrying until we hit one.
+    const uint32_t current = tag_cache_mask(&state->tags, box) & ALL_COLORS_MASK;
+    uint32_t num_candidates = 0;
+    for (uint32_t c = 0; c < NUM_COLORS; ++c)
+        num_candidates += !(current & (1u << c));
+
+    uint32_t color = 0;
+    if (num_candidates)
     {
-    case 0:
-        tag = red_tag;
-        break;
-    case 1:
-        tag = green_tag;
-        break;
-    case 2:
-        tag = blue_tag;
-        break;
+        uint32_t n = (uint32_t)(next_random(&state->random_state) % num_candidates);
+        for (color = 0; color < NUM_COLORS; ++color)
+        {
+            if (!(current & (1u << color)) && n-- == 0)
+                break;
+        }
     }
 
-    tm_tag_component_api->remove_tag(state->tag_mgr, box, red_tag);
-    tm_tag_component_api->remove_tag(state->tag_mgr, box, green_tag);
-    tm_tag_component_api->remove_tag(state->tag_mgr, box, blue_tag);
-    tm_tag_component_api->add_tag(state->tag_mgr, box, tag);
+    state->agents.box_color[i] = color;
+    tag_cache_set(&state->tags, box, 1u << color, ALL_COLORS_MASK);
 
-    update_box_material(state);
+    update_box_material(state, i);
 }
 
-static tm_simulation_state_o *start(tm_simulation_start_args_t *args)
+static tm_simulation_state_o *start_with_recorder(tm_simulation_start_args_t *args, enum input_recorder_mode mode)
 {
     tm_simulation_state_o *state = tm_alloc(args->allocator, sizeof(*state));
     *state = (tm_simulation_state_o){
@@ -322,8 +723,18 @@ static tm_simulation_state_o *start(tm_simulation_start_args_t *args)
         .entity_ctx = args->entity_ctx,
         .sim = args->simulation_ctx,
         .asset_root = args->asset_root,
+        .first_bot = 1,
     };
 
+    input_recorder_init(&state->recorder, state->allocator, mode, INPUT_RECORDING_PATH, tm_random_api->next());
+    state->random_state = state->recorder.seed;
+
+    state->contact_lookup.allocator = state->allocator;
+
+    state->box_materials[0] = tm_the_truth_assets_api->asset_object_from_path(state->tt, state->asset_root, "materials/box-red-mat.creation");
+    state->box_materials[1] = tm_the_truth_assets_api->asset_object_from_path(state->tt, state->asset_root, "materials/box-green-mat.creation");
+    state->box_materials[2] = tm_the_truth_assets_api->asset_object_from_path(state->tt, state->asset_root, "materials/box-blue-mat.creation");
+
     state->mover_component = tm_entity_api->lookup_component_type(state->entity_ctx, TM_TT_TYPE_HASH__PHYSICS_MOVER_COMPONENT);
     state->joint_component = tm_entity_api->lookup_component_type(state->entity_ctx, TM_TT_TYPE_HASH__PHYSICS_JOINT_COMPONENT);
     state->shape_component = tm_entity_api->lookup_component_type(state->entity_ctx, TM_TT_TYPE_HASH__PHYSICS_SHAPE_COMPONENT);
@@ -333,16 +744,18 @@ static tm_simulation_state_o *start(tm_simulation_start_args_t *args)
 
     state->trans_mgr = (tm_transform_component_manager_o *)tm_entity_api->component_manager(state->entity_ctx, state->transform_component);
     state->tag_mgr = (tm_tag_component_manager_o *)tm_entity_api->component_manager(state->entity_ctx, state->tag_component);
+    tag_cache_init(&state->tags, state->tag_mgr, state->allocator);
+    raycast_batch_init(&state->rays, state->allocator);
 
-    state->player = tm_tag_component_api->find_first(state->tag_mgr, TM_STATIC_HASH("player", 0xafff68de8a0598dfULL));
-    state->player_camera = tm_tag_component_api->find_first(state->tag_mgr, TM_STATIC_HASH("player_camera", 0x689cd442a211fda4ULL));
-    tm_simulation_api->set_camera(state->sim, state->player_camera);
-    state->player_carry_anchor = tm_tag_component_api->find_first(state->tag_mgr, TM_STATIC_HASH("player_carry_anchor", 0xc3ff6c2ebc868f1fULL));
+    const tm_entity_t player = tm_tag_component_api->find_first(state->tag_mgr, TM_STATIC_HASH("player", 0xafff68de8a0598dfULL));
+    const tm_entity_t player_camera = tm_tag_component_api->find_first(state->tag_mgr, TM_STATIC_HASH("player_camera", 0x689cd442a211fda4ULL));
+    tm_simulation_api->set_camera(state->sim, player_camera);
+    const tm_entity_t player_carry_anchor = tm_tag_component_api->find_first(state->tag_mgr, TM_STATIC_HASH("player_carry_anchor", 0xc3ff6c2ebc868f1fULL));
+    state->eye_offset = tm_vec3_sub(tm_get_position(state->trans_mgr, player_camera), tm_get_position(state->trans_mgr, player));
 
-    state->box = tm_tag_component_api->find_first(state->tag_mgr, TM_STATIC_HASH("box", 0x9eef98b479cef090ULL));
-    const tm_transform_component_t *box_trans = tm_entity_api->read_component(state->entity_ctx, state->box, state->transform_component);
-    state->box_starting_point = box_trans->world.pos;
-    state->box_starting_rot = box_trans->world.rot;
+    const tm_entity_t box = tm_tag_component_api->find_first(state->tag_mgr, TM_STATIC_HASH("box", 0x9eef98b479cef090ULL));
+    const tm_transform_component_t *box_trans = tm_entity_api->read_component(state->entity_ctx, box, state->transform_component);
+    push_agent(state, player, player_camera, player_carry_anchor, box, box_trans->world.pos, box_trans->world.rot);
 
     TM_INIT_TEMP_ALLOCATOR(ta);
     const tm_physics_collision_t *collision_types = tm_physics_collision_api->find_all(state->tt, ta);
@@ -368,132 +781,142 @@ static tm_simulation_state_o *start(tm_simulation_start_args_t *args)
 
     tm_gamestate_api->add_singleton(gamestate, s, state);
     if (!tm_gamestate_api->deserialize_singleton(gamestate, singleton_name, state))
-        change_box_to_random_color(state);
+        change_box_to_random_color(state, 0);
+    tag_cache_flush(&state->tags);
 
     TM_SHUTDOWN_TEMP_ALLOCATOR(ta);
 
     return state;
 }
 
+static tm_simulation_state_o *start(tm_simulation_start_args_t *args)
+{
+    return start_with_recorder(args, INPUT_RECORDER_MODE_OFF);
+}
+
+// Logs the cost per tick of a replay and the raycasts it made.
+static void log_replay_stats(tm_simulation_state_o *state)
+{
+    input_recorder_log_replay_stats(&state->recorder);
+    raycast_batch_log_stats(&state->rays, state->recorder.num_frames);
+}
+
 static void stop(tm_simulation_state_o *state, struct tm_entity_commands_o *commands)
 {
     tm_allocator_i a = *state->allocator;
+    // A replay that reached the end of the log has already logged its cost, see `tick_replay()`.
+    if (state->recorder.mode == INPUT_RECORDER_MODE_REPLAY)
+        log_replay_stats(state);
+    input_recorder_shutdown(&state->recorder);
+    free_agents(&state->agents, &a);
+    tm_carray_free(state->contact_buckets, &a);
+    tm_carray_free(state->contact_others, &a);
+    tm_hash_free(&state->contact_lookup);
+    tag_cache_free(&state->tags);
+    raycast_batch_free(&state->rays);
     tm_free(&a, state, sizeof(*state));
 }
 
-static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
+// Spawns a bot with its own player, carry anchor and box, created from the assets of the local player's
+// entities. Bots are laid out on a grid next to the local player, so that they don't start inside each
+// other.
+static void spawn_bot(tm_simulation_state_o *state)
 {
-    // Reset per-frame-input
-    state->input.mouse_delta.x = state->input.mouse_delta.y = 0;
-    state->input.left_mouse_pressed = false;
-    //state->render_backend = args->render_backend;
+    agents_t *ag = &state->agents;
+    const uint32_t slot = state->num_agents;
+    const tm_vec3_t offset = {(float)(slot % 32) * 3.0f, 0, (float)(slot / 32) * 3.0f};
 
-    // Read input
-    tm_input_event_t events[32];
-    bool mouse_captured_this_frame = state->mouse_captured;
-    while (true)
-    {
-        uint64_t n = tm_input_api->events(state->processed_events, events, 32);
+    const tm_entity_t player = tm_entity_api->create_entity_from_asset(state->entity_ctx, tm_entity_api->asset(state->entity_ctx, ag->player[0]));
+    const tm_entity_t carry_anchor = tm_entity_api->create_entity_from_asset(state->entity_ctx, tm_entity_api->asset(state->entity_ctx, ag->carry_anchor[0]));
+    const tm_entity_t box = tm_entity_api->create_entity_from_asset(state->entity_ctx, tm_entity_api->asset(state->entity_ctx, ag->box[0]));
 
-        for (uint64_t i = 0; i < n; ++i)
-        {
-            const tm_input_event_t *e = events + i;
-            if (mouse_captured_this_frame)
-            {
-                if (e->source && e->source->controller_type == TM_INPUT_CONTROLLER_TYPE_MOUSE)
-                {
-                    if (e->item_id == TM_INPUT_MOUSE_ITEM_BUTTON_LEFT)
-                    {
-                        const bool down = e->data.f.x > 0.5f;
-                        state->input.left_mouse_pressed = down && !state->input.left_mouse_held;
-                        state->input.left_mouse_held = down;
-                    }
-                    else if (e->item_id == TM_INPUT_MOUSE_ITEM_MOVE)
-                    {
-                        state->input.mouse_delta.x += e->data.f.x;
-                        state->input.mouse_delta.y += e->data.f.y;
-                    }
-                }
-                if (e->source && e->source->controller_type == TM_INPUT_CONTROLLER_TYPE_KEYBOARD)
-                {
-                    if (e->type == TM_INPUT_EVENT_TYPE_DATA_CHANGE)
-                    {
-                        state->input.held_keys[e->item_id] = e->data.f.x == 1.0f;
-                    }
-                }
-            }
-            else
-            {
-                if (e->source && e->source->controller_type == TM_INPUT_CONTROLLER_TYPE_MOUSE)
-                {
-                    if (e->item_id == TM_INPUT_MOUSE_ITEM_BUTTON_LEFT)
-                    {
-                        const bool down = e->data.f.x > 0.5f;
-                        state->input.left_mouse_pressed = down && !state->input.left_mouse_held;
-                        state->input.left_mouse_held = down;
-                    }
-                }
+    const tm_vec3_t box_starting_point = tm_vec3_add(ag->box_starting_point[0], offset);
+    tm_set_position(state->trans_mgr, player, tm_vec3_add(tm_get_position(state->trans_mgr, ag->player[0]), offset));
+    tm_set_position(state->trans_mgr, box, box_starting_point);
 
-                if (e->source && e->source->controller_type == TM_INPUT_CONTROLLER_TYPE_KEYBOARD)
-                {
-                    if (e->item_id == TM_INPUT_KEYBOARD_ITEM_ESCAPE && e->type == TM_INPUT_EVENT_TYPE_DATA_CHANGE)
-                    {
-                        state->input.held_keys[e->item_id] = e->data.f.x == 1.0f;
-                    }
-                }
-            }
-        }
+    const uint32_t i = push_agent(state, player, (tm_entity_t){0}, carry_anchor, box, box_starting_point, ag->box_starting_rot[0]);
+    change_box_to_random_color(state, i);
+}
 
-        state->processed_events += n;
-        if (n < 32)
-            break;
-    }
+// Sets the controls of the local player (agent 0) from the input.
+static void update_player_controls(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
+{
+    agent_controls_t *c = state->agents.controls;
+    *c = (agent_controls_t){.interact = state->input.left_mouse_pressed};
 
-    // Capture mouse
-    if (args->ui)
+    // Process input if mouse is captured.
+    if (state->mouse_captured)
     {
-        if (!args->running_in_editor || (tm_ui_api->is_hovering(args->ui, args->rect, 0) && state->input.left_mouse_pressed))
-        {
-            state->mouse_captured = true;
-        }
+        // Exit on ESC
+        if (!args->running_in_editor && input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_ESCAPE))
+            tm_application_api->exit(tm_application_api->application(), false);
 
-        if ((args->running_in_editor && state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_ESCAPE]) || !tm_ui_api->window_has_focus(args->ui))
-        {
-            state->mouse_captured = false;
-            struct tm_application_o *app = tm_application_api->application();
-            tm_application_api->set_cursor_hidden(app, false);
-        }
+        c->actions = input_actions_held(&state->input, action_keys, TM_ARRAY_COUNT(action_keys));
 
-        if (state->mouse_captured)
-        {
-            struct tm_application_o *app = tm_application_api->application();
-            tm_application_api->set_cursor_hidden(app, true);
-        }
+        const float mouse_sens = 0.1f * args->dt;
+        c->look_delta = (tm_vec2_t){-state->input.mouse_delta.x * mouse_sens, -state->input.mouse_delta.y * mouse_sens};
     }
+}
 
-    tm_physx_scene_o *physx_scene = args->physx_scene;
-    const tm_vec3_t camera_pos = tm_get_position(state->trans_mgr, state->player_camera);
-    const tm_vec4_t camera_rot = tm_get_rotation(state->trans_mgr, state->player_camera);
-    struct tm_physics_mover_component_t *player_mover = tm_entity_api->write_component(state->entity_ctx, state->player, state->mover_component);
+// Sets the controls of bot `i`. Bots act like restless players: they keep walking in a random direction and
+// turning for a random while, sometimes jumping, and click whenever they pick something new to do, which
+// picks up or drops their box if they are looking at it.
+static void update_bot_controls(tm_simulation_state_o *state, uint32_t i, float dt)
+{
+    agents_t *ag = &state->agents;
+    agent_controls_t *c = ag->controls + i;
+    *c = (agent_controls_t){0};
+
+    ag->bot_timer[i] -= dt;
+    if (ag->bot_timer[i] <= 0)
+    {
+        const uint64_t r = next_random(&state->random_state);
+        ag->bot_timer[i] = 0.5f + 1.5f * (float)(r & 0xffff) / 0xffff;
+        ag->bot_actions[i] = (uint32_t)(r >> 16) & ((1u << ACTION_COUNT) - 1);
+        ag->bot_turn_speed[i] = 2.0f * ((float)((r >> 32) & 0xffff) / 0xffff - 0.5f);
+        c->interact = true;
+    }
+
+    c->actions = ag->bot_actions[i];
+    c->look_delta = (tm_vec2_t){ag->bot_turn_speed[i] * dt, 0};
+}
+
+// Applies the controls of agent `i` to its player and moves its carry anchor. Only touches the agent's own
+// entities.
+static void update_agent_movement(tm_simulation_state_o *state, uint32_t i, float dt)
+{
+    agents_t *ag = &state->agents;
+    const agent_controls_t *c = ag->controls + i;
+    struct tm_physics_mover_component_t *player_mover = tm_entity_api->write_component(state->entity_ctx, ag->player[i], state->mover_component);
 
     if (!TM_ASSERT(player_mover, "Invalid player"))
         return;
 
-    // Process input if mouse is captured.
-    if (state->mouse_captured)
+    // The view at the start of the frame. Bots don't have a camera, so their view is computed.
+    if (ag->camera[i].u64)
     {
-        // Exit on ESC
-        if (!args->running_in_editor && state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_ESCAPE])
-            tm_application_api->exit(tm_application_api->application(), false);
+        ag->view_pos[i] = tm_get_position(state->trans_mgr, ag->camera[i]);
+        ag->view_rot[i] = tm_get_rotation(state->trans_mgr, ag->camera[i]);
+    }
+    else
+    {
+        ag->view_pos[i] = tm_vec3_add(tm_get_position(state->trans_mgr, ag->player[i]), state->eye_offset);
+        ag->view_rot[i] = ag->look_rot[i];
+    }
+    const tm_vec3_t camera_pos = ag->view_pos[i];
+    const tm_vec4_t camera_rot = ag->view_rot[i];
 
+    // The local player only moves while the mouse is captured.
+    if (i >= state->first_bot || state->mouse_captured)
+    {
         tm_vec3_t local_movement = {0};
-        if (state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_A])
+        if (c->actions & (1 << ACTION_LEFT))
             local_movement.x -= 1.0f;
-        if (state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_D])
+        if (c->actions & (1 << ACTION_RIGHT))
             local_movement.x += 1.0f;
-        if (state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_W])
+        if (c->actions & (1 << ACTION_FORWARD))
             local_movement.z -= 1.0f;
-        if (state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_S])
+        if (c->actions & (1 << ACTION_BACK))
             local_movement.z += 1.0f;
 
         // Move
@@ -513,103 +936,94 @@ static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
         }
 
         // Look
-        const float mouse_sens = 0.1f * args->dt;
-        state->look_yaw -= state->input.mouse_delta.x * mouse_sens;
-        state->look_pitch -= state->input.mouse_delta.y * mouse_sens;
-        state->look_pitch = tm_clamp(state->look_pitch, -TM_PI / 3, TM_PI / 3);
-        const tm_vec4_t yawq = tm_quaternion_from_rotation((tm_vec3_t){0, 1, 0}, state->look_yaw);
+        ag->look_yaw[i] += c->look_delta.x;
+        ag->look_pitch[i] += c->look_delta.y;
+        ag->look_pitch[i] = tm_clamp(ag->look_pitch[i], -TM_PI / 3, TM_PI / 3);
+        const tm_vec4_t yawq = tm_quaternion_from_rotation((tm_vec3_t){0, 1, 0}, ag->look_yaw[i]);
         const tm_vec3_t local_sideways = tm_quaternion_rotate_vec3(yawq, (tm_vec3_t){1, 0, 0});
-        const tm_vec4_t pitchq = tm_quaternion_from_rotation(local_sideways, state->look_pitch);
-        tm_set_local_rotation(state->trans_mgr, state->player_camera, tm_quaternion_mul(pitchq, yawq));
+        const tm_vec4_t pitchq = tm_quaternion_from_rotation(local_sideways, ag->look_pitch[i]);
+        ag->look_rot[i] = tm_quaternion_mul(pitchq, yawq);
+        if (ag->camera[i].u64)
+            tm_set_local_rotation(state->trans_mgr, ag->camera[i], ag->look_rot[i]);
 
         // Jump
-        if (state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_SPACE] && player_mover->is_standing)
+        if ((c->actions & (1 << ACTION_JUMP)) && player_mover->is_standing)
             player_mover->velocity.y = 5;
     }
 
     // Box carry anchor is kinematic physics body (so we can put joints on it), move it manually
     const tm_vec3_t camera_forward = tm_quaternion_rotate_vec3(camera_rot, (tm_vec3_t){0, 0, -1});
-    const tm_vec3_t anchor_pos = tm_vec3_add(tm_vec3_add(camera_pos, tm_vec3_mul(camera_forward, 1.5f)), tm_vec3_mul(player_mover->velocity, args->dt));
+    ag->anchor_pos[i] = tm_vec3_add(tm_vec3_add(camera_pos, tm_vec3_mul(camera_forward, 1.5f)), tm_vec3_mul(player_mover->velocity, dt));
+
+    tm_set_position(state->trans_mgr, ag->carry_anchor[i], ag->anchor_pos[i]);
+    tm_set_rotation(state->trans_mgr, ag->carry_anchor[i], camera_rot);
+}
 
-    tm_set_position(state->trans_mgr, state->player_carry_anchor, anchor_pos);
-    tm_set_rotation(state->trans_mgr, state->player_carry_anchor, camera_rot);
+// Runs the box state machine of agent `i`.
+static void update_box(tm_simulation_state_o *state, uint32_t i, tm_physx_scene_o *physx_scene, float dt)
+{
+    agents_t *ag = &state->agents;
+    const tm_entity_t box = ag->box[i];
+    const bool interact = ag->controls[i].interact;
+    const tm_vec3_t camera_forward = tm_quaternion_rotate_vec3(ag->view_rot[i], (tm_vec3_t){0, 0, -1});
 
-    // Update box color if necessary.
-    update_box_material(state);
-    state->box_interactable = false;
+    ag->box_interactable[i] = false;
 
-    // Box state machine
-    switch (state->box_state)
+    switch (ag->box_state[i])
     {
     case BOX_STATE_FREE:
     {
         // Check if box is in a drop zone that has the same color as itself
+        const bool touching_correct_drop_zone = touches_color(state, box, tag_cache_mask(&state->tags, box));
 
-        bool touching_correct_drop_zone = false;
-        tm_physx_on_contact_t *contact_events = tm_physx_scene_api->on_contact(physx_scene);
-        for (tm_physx_on_contact_t *t = contact_events; t != tm_carray_end(contact_events); ++t)
-        {
-            const tm_entity_t e0 = t->actor_0;
-            const tm_entity_t e1 = t->actor_1;
-
-            if (e0.u64 != state->box.u64 && e1.u64 != state->box.u64)
-                continue;
-
-            const bool correct_floor = (tm_tag_component_api->has_tag(state->tag_mgr, e0, red_tag) && tm_tag_component_api->has_tag(state->tag_mgr, e1, red_tag)) || (tm_tag_component_api->has_tag(state->tag_mgr, e0, green_tag) && tm_tag_component_api->has_tag(state->tag_mgr, e1, green_tag)) || (tm_tag_component_api->has_tag(state->tag_mgr, e0, blue_tag) && tm_tag_component_api->has_tag(state->tag_mgr, e1, blue_tag));
-
-            if (!correct_floor)
-                continue;
-
-            touching_correct_drop_zone = true;
-        }
-
-        const tm_vec3_t box_pos = tm_get_position(state->trans_mgr, state->box);
+        const tm_vec3_t box_pos = tm_get_position(state->trans_mgr, box);
         // tm_physics_body_component_t* box_body = tm_entity_api->get_component(state->entity_ctx, state->box, state->physx_rigid_body_component);
         if (touching_correct_drop_zone)
         {
             // If box is in correct drop zone and has low velocity, send it flying upwards.
 
-            const tm_vec3_t box_velocity = tm_physx_scene_api->velocity(physx_scene, state->box);
+            const tm_vec3_t box_velocity = tm_physx_scene_api->velocity(physx_scene, box);
 
             if (tm_vec3_length(box_velocity) < 0.01)
             {
-                tm_physx_scene_api->add_force(physx_scene, state->box, (tm_vec3_t){0, 10, 0}, TM_PHYSX_FORCE_FLAGS__VELOCITY_CHANGE);
-                state->box_fly_timer = 0.7f;
-                state->box_state = BOX_STATE_FLYING_UP;
-                state->score += 1.0f;
+                tm_physx_scene_api->add_force(physx_scene, box, (tm_vec3_t){0, 10, 0}, TM_PHYSX_FORCE_FLAGS__VELOCITY_CHANGE);
+                ag->box_fly_timer[i] = 0.7f;
+                ag->box_state[i] = BOX_STATE_FLYING_UP;
+                ag->score[i] += 1.0f;
             }
         }
         else if (box_pos.y < -10.0f)
         {
-            tm_physx_scene_api->set_velocity(physx_scene, state->box, (tm_vec3_t){0, 20, 0});
-            state->box_fly_timer = 1.0f;
-            state->box_state = BOX_STATE_FLYING_UP;
+            tm_physx_scene_api->set_velocity(physx_scene, box, (tm_vec3_t){0, 20, 0});
+            ag->box_fly_timer[i] = 1.0f;
+            ag->box_state[i] = BOX_STATE_FLYING_UP;
         }
         else
         {
-            // If box is not in correct drop zone and player clicks left mouse button, try picking it up using raycast.
+            // If box is not in correct drop zone and player clicks left mouse button, try picking it up using the
+            // raycast made in the probe phase.
 
-            const tm_physx_raycast_t r = tm_physx_scene_api->raycast(physx_scene, camera_pos, camera_forward, 2.5f, state->player_collision_type, (tm_physx_raycast_flags_t){0}, 0, 0);
+            const tm_physx_raycast_t *r = ag->box_probe[i] != UINT32_MAX ? raycast_batch_result(&state->rays, ag->box_probe[i]) : 0;
 
-            if (r.has_block)
+            if (r && r->has_block)
             {
-                const tm_entity_t hit = r.block.body;
+                const tm_entity_t hit = r->block.body;
 
-                if (state->box.u64 == hit.u64)
+                if (box.u64 == hit.u64)
                 {
-                    state->box_interactable = true;
+                    ag->box_interactable[i] = true;
 
-                    if (state->input.left_mouse_pressed)
+                    if (interact)
                         {
-                        tm_physics_shape_component_t *shape = tm_entity_api->write_component(state->entity_ctx, state->box, state->shape_component);
+                        tm_physics_shape_component_t *shape = tm_entity_api->write_component(state->entity_ctx, box, state->shape_component);
                             tm_physx_scene_api->update_collision_id(physx_scene, shape, state->player_collision_type);
 
-                        tm_set_position(state->trans_mgr, state->box, anchor_pos);
-                        tm_physics_joint_component_t *j = tm_entity_api->add_component(state->entity_ctx, state->box, state->joint_component);
+                        tm_set_position(state->trans_mgr, box, ag->anchor_pos[i]);
+                        tm_physics_joint_component_t *j = tm_entity_api->add_component(state->entity_ctx, box, state->joint_component);
                         j->joint_type = TM_PHYSICS_JOINT__FIXED;
-                        j->body_0 = state->box;
-                        j->body_1 = state->player_carry_anchor;
-                        state->box_state = BOX_STATE_CARRIED;
+                        j->body_0 = box;
+                        j->body_1 = ag->carry_anchor[i];
+                        ag->box_state[i] = BOX_STATE_CARRIED;
                     }
                 }
             }
@@ -619,28 +1033,28 @@ static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
 
     case BOX_STATE_CARRIED:
     {
-        if (state->input.left_mouse_pressed)
+        if (interact)
         {
             // Drop box
-            tm_entity_api->remove_component(state->entity_ctx, state->box, state->joint_component);
-            tm_physics_shape_component_t *shape = tm_entity_api->write_component(state->entity_ctx, state->box, state->shape_component);
+            tm_entity_api->remove_component(state->entity_ctx, box, state->joint_component);
+            tm_physics_shape_component_t *shape = tm_entity_api->write_component(state->entity_ctx, box, state->shape_component);
                 tm_physx_scene_api->update_collision_id(physx_scene, shape, state->box_collision_type);
 
-            tm_physx_scene_api->set_kinematic(physx_scene, state->box, false);
-            tm_physx_scene_api->add_force(physx_scene, state->box, tm_vec3_mul(camera_forward, 1500 * args->dt), TM_PHYSX_FORCE_FLAGS__IMPULSE);
-            state->box_state = BOX_STATE_FREE;
+            tm_physx_scene_api->set_kinematic(physx_scene, box, false);
+            tm_physx_scene_api->add_force(physx_scene, box, tm_vec3_mul(camera_forward, 1500 * dt), TM_PHYSX_FORCE_FLAGS__IMPULSE);
+            ag->box_state[i] = BOX_STATE_FREE;
         }
     }
     break;
 
     case BOX_STATE_FLYING_UP:
     {
-        state->box_fly_timer -= args->dt;
+        ag->box_fly_timer[i] -= dt;
 
-        if (state->box_fly_timer <= 0.0001f)
+        if (ag->box_fly_timer[i] <= 0.0001f)
         {
-            tm_physx_scene_api->set_kinematic(physx_scene, state->box, true);
-            state->box_state = BOX_STATE_FLYING_BACK;
+            tm_physx_scene_api->set_kinematic(physx_scene, box, true);
+            ag->box_state[i] = BOX_STATE_FLYING_BACK;
         }
     }
     break;
@@ -650,32 +1064,121 @@ static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
         // This state interpolates the box back to its initial position and changes the
         // color once it reaches it.
 
-        const tm_vec3_t box_pos = tm_get_position(state->trans_mgr, state->box);
-        const tm_vec3_t box_to_spawn = tm_vec3_sub(state->box_starting_point, box_pos);
+        const tm_vec3_t box_pos = tm_get_position(state->trans_mgr, box);
+        const tm_vec3_t box_to_spawn = tm_vec3_sub(ag->box_starting_point[i], box_pos);
         const tm_vec3_t spawn_point_dir = tm_vec3_normalize(box_to_spawn);
 
         if (tm_vec3_length(box_to_spawn) < 0.1f)
         {
-            tm_set_position(state->trans_mgr, state->box, state->box_starting_point);
-            tm_physx_scene_api->set_kinematic(physx_scene, state->box, false);
-            tm_physx_scene_api->set_velocity(physx_scene, state->box, (tm_vec3_t){0, 0, 0});
-            change_box_to_random_color(state);
-            state->box_state = BOX_STATE_FREE;
+            tm_set_position(state->trans_mgr, box, ag->box_starting_point[i]);
+            tm_physx_scene_api->set_kinematic(physx_scene, box, false);
+            tm_physx_scene_api->set_velocity(physx_scene, box, (tm_vec3_t){0, 0, 0});
+            change_box_to_random_color(state, i);
+            ag->box_state[i] = BOX_STATE_FREE;
         }
         else
         {
-            const tm_vec3_t interpolate_to_start_pos = tm_vec3_add(box_pos, tm_vec3_mul(spawn_point_dir, args->dt * 10));
-            tm_set_position(state->trans_mgr, state->box, interpolate_to_start_pos);
+            const tm_vec3_t interpolate_to_start_pos = tm_vec3_add(box_pos, tm_vec3_mul(spawn_point_dir, dt * 10));
+            tm_set_position(state->trans_mgr, box, interpolate_to_start_pos);
         }
     }
     break;
     }
+}
+
+// Adds the time since `*clock` to `phase` and restarts the clock.
+static void end_phase(tm_simulation_state_o *state, enum tick_phase phase, tm_clock_o *clock)
+{
+    const tm_clock_o now = tm_os_api->time->now();
+    state->phase_seconds[phase] += tm_os_api->time->delta(now, *clock);
+    *clock = now;
+}
+
+static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
+{
+    //state->render_backend = args->render_backend;
+
+    // Read input. When replaying, this also replaces the time and delta time with the recorded ones.
+    if (!input_recorder_update(&state->recorder, &state->input, &state->mouse_captured, &args->time, &args->dt))
+        return;
+
+    // Capture mouse
+    if (args->ui)
+    {
+        if (!args->running_in_editor || (tm_ui_api->is_hovering(args->ui, args->rect, 0) && state->input.left_mouse_pressed))
+        {
+            state->mouse_captured = true;
+        }
+
+        if ((args->running_in_editor && input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_ESCAPE)) || !tm_ui_api->window_has_focus(args->ui))
+        {
+            state->mouse_captured = false;
+            struct tm_application_o *app = tm_application_api->application();
+            tm_application_api->set_cursor_hidden(app, false);
+        }
+
+        if (state->mouse_captured)
+        {
+            struct tm_application_o *app = tm_application_api->application();
+            tm_application_api->set_cursor_hidden(app, true);
+        }
+    }
+
+    tm_physx_scene_o *physx_scene = args->physx_scene;
+    agents_t *ag = &state->agents;
+    tm_clock_o clock = tm_os_api->time->now();
+
+    // Controls: the local player from input, everybody else from bots.
+    if (state->first_bot > 0)
+        update_player_controls(state, args);
+    for (uint32_t i = state->first_bot; i < state->num_agents; ++i)
+        update_bot_controls(state, i, args->dt);
+    end_phase(state, TICK_PHASE_CONTROLS, &clock);
+
+    // Movement only touches each agent's own player and carry anchor.
+    for (uint32_t i = 0; i < state->num_agents; ++i)
+        update_agent_movement(state, i, args->dt);
+    end_phase(state, TICK_PHASE_MOVEMENT, &clock);
+
+    // Update box materials if the color has changed (or the box was respawned) since they were last bound.
+    for (uint32_t i = 0; i < state->num_agents; ++i)
+        update_box_material(state, i);
+    end_phase(state, TICK_PHASE_MATERIALS, &clock);
+
+    // Index this frame's contacts by entity, so the state machines can look up what the boxes touch.
+    build_contact_index(state, tm_physx_scene_api->on_contact(physx_scene));
+    end_phase(state, TICK_PHASE_CONTACTS, &clock);
+
+    // Queue a ray along the view of each agent with a free box, to see if it looks at its box, and run them all
+    // in one batch. The box state machines below read the results. Boxes in the drop zone of their color
+    // can't be picked up, so they don't need a ray.
+    raycast_batch_reset(&state->rays);
+    for (uint32_t i = 0; i < state->num_agents; ++i)
+    {
+        ag->box_probe[i] = UINT32_MAX;
+        if (ag->box_state[i] == BOX_STATE_FREE && !touches_color(state, ag->box[i], tag_cache_mask(&state->tags, ag->box[i])))
+        {
+            const tm_vec3_t forward = tm_quaternion_rotate_vec3(ag->view_rot[i], (tm_vec3_t){0, 0, -1});
+            ag->box_probe[i] = raycast_batch_add(&state->rays, ag->view_pos[i], forward, 2.5f, state->player_collision_type);
+        }
+    }
+    raycast_batch_execute(&state->rays, physx_scene);
+    end_phase(state, TICK_PHASE_PROBES, &clock);
+
+    // Box state machines. These query and change the physics scene, so they run one agent at a time.
+    for (uint32_t i = 0; i < state->num_agents; ++i)
+        update_box(state, i, physx_scene, args->dt);
+    end_phase(state, TICK_PHASE_BOXES, &clock);
+
+    // Send the tag changes made this frame to the tag component manager.
+    tag_cache_flush(&state->tags);
+    end_phase(state, TICK_PHASE_TAGS, &clock);
 
     if (args->ui)
     {
         // UI: Score
         char label_text[128];
-        snprintf(label_text, 128, "The box has been correctly placed %.0f times", state->score);
+        snprintf(label_text, 128, "The box has been correctly placed %.0f times", ag->score[0]);
         tm_rect_t rect = {5, 5, 20, 20};
         tm_ui_api->label(args->ui, args->uistyle, &(tm_ui_label_t){.rect = rect, .text = label_text});
 
@@ -685,7 +1188,7 @@ static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
         tm_draw2d_style_t style[1] = {0};
         tm_ui_api->to_draw_style(args->ui, style, args->uistyle);
 
-        style->color = (state->box_interactable || state->box_state == BOX_STATE_CARRIED)
+        style->color = (ag->box_interactable[0] || ag->box_state[0] == BOX_STATE_CARRIED)
                            ? (tm_color_srgb_t){255, 255, 255, 255}
                            : (tm_color_srgb_t){120, 120, 120, 255};
 
@@ -701,6 +1204,123 @@ static tm_simulation_entry_i simulation_entry_i = {
     .tick = tick,
 };
 
+static tm_simulation_state_o *start_record(tm_simulation_start_args_t *args)
+{
+    return start_with_recorder(args, INPUT_RECORDER_MODE_RECORD);
+}
+
+static tm_simulation_state_o *start_replay(tm_simulation_start_args_t *args)
+{
+    return start_with_recorder(args, INPUT_RECORDER_MODE_REPLAY);
+}
+
+// Ticks the simulation with the recorded input, without UI, and measures the cost of the gameplay code.
+// Plays `INPUT_RECORDER_REPLAY_FRAMES_PER_TICK` recorded frames per call. When the log runs out, it logs the
+// cost and stops ticking the simulation.
+static void tick_replay(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
+{
+    if (state->recorder.mode == INPUT_RECORDER_MODE_REPLAY_DONE)
+        return;
+
+    for (uint32_t i = 0; i < INPUT_RECORDER_REPLAY_FRAMES_PER_TICK; ++i)
+    {
+        tm_simulation_frame_args_t replay_args = *args;
+        replay_args.ui = 0;
+
+        const tm_clock_o start_time = tm_os_api->time->now();
+        tick(state, &replay_args);
+        const double seconds = tm_os_api->time->delta(tm_os_api->time->now(), start_time);
+
+        if (state->recorder.mode == INPUT_RECORDER_MODE_REPLAY_DONE)
+        {
+            log_replay_stats(state);
+            return;
+        }
+        state->recorder.replay_tick_seconds += seconds;
+
+        // If the log couldn't be loaded, the simulation plays on live input, one frame per tick.
+        if (state->recorder.mode != INPUT_RECORDER_MODE_REPLAY)
+            return;
+    }
+}
+
+static tm_simulation_state_o *start_stress(tm_simulation_start_args_t *args)
+{
+    tm_simulation_state_o *state = start_with_recorder(args, INPUT_RECORDER_MODE_OFF);
+    state->first_bot = 0;
+    return state;
+}
+
+// Runs the stages of the stress test: for each count in `stress_agent_counts`, spawns bots until there are
+// that many agents and ticks the simulation `STRESS_TICKS_PER_STAGE` times without UI. After each stage it
+// logs the ticks per second, the time spent in each `enum tick_phase` and the raycast totals. Spawning is
+// not timed.
+static void tick_stress(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
+{
+    if (state->stress_stage >= TM_ARRAY_COUNT(stress_agent_counts))
+        return;
+
+    if (!state->stress_ticks)
+    {
+        while (state->num_agents < stress_agent_counts[state->stress_stage])
+            spawn_bot(state);
+        tag_cache_flush(&state->tags);
+
+        for (uint32_t p = 0; p < TICK_PHASE_COUNT; ++p)
+            state->phase_seconds[p] = 0;
+        state->stress_seconds = 0;
+        raycast_batch_reset_stats(&state->rays);
+    }
+
+    tm_simulation_frame_args_t stress_args = *args;
+    stress_args.ui = 0;
+
+    const tm_clock_o start_time = tm_os_api->time->now();
+    tick(state, &stress_args);
+    state->stress_seconds += tm_os_api->time->delta(tm_os_api->time->now(), start_time);
+
+    if (++state->stress_ticks == STRESS_TICKS_PER_STAGE)
+    {
+        const double seconds_per_tick = state->stress_seconds / STRESS_TICKS_PER_STAGE;
+        TM_LOG("Stress test with %u agents: %.1f ticks per second (%.1f us per tick)", state->num_agents, seconds_per_tick > 0 ? 1.0 / seconds_per_tick : 0.0, seconds_per_tick * 1e6);
+        for (uint32_t p = 0; p < TICK_PHASE_COUNT; ++p)
+            TM_LOG("    %-10s %.1f us per tick", tick_phase_names[p], state->phase_seconds[p] / STRESS_TICKS_PER_STAGE * 1e6);
+        raycast_batch_log_stats(&state->rays, STRESS_TICKS_PER_STAGE);
+
+        state->stress_ticks = 0;
+        ++state->stress_stage;
+    }
+}
+
+// Plays like the regular entry, but records the input to `INPUT_RECORDING_PATH` when stopped.
+static tm_simulation_entry_i record_simulation_entry_i = {
+    .id = TM_STATIC_HASH("tm_gameplay_sample_first_person_record_simulate_entry_i", 0x189780b6aaaead25ULL),
+    .display_name = TM_LOCALIZE_LATER("Gameplay Sample First Person (Record Input)"),
+    .start = start_record,
+    .stop = stop,
+    .tick = tick,
+};
+
+// Replays `INPUT_RECORDING_PATH` and logs the cost per tick at the end of the log, or when stopped before
+// that. PhysX steps with the live frame time, so the replay is not deterministic: the player and the bots
+// can end up in different places than in the recording, and raycasts can hit different things.
+static tm_simulation_entry_i replay_simulation_entry_i = {
+    .id = TM_STATIC_HASH("tm_gameplay_sample_first_person_replay_simulate_entry_i", 0xede27242fca9028fULL),
+    .display_name = TM_LOCALIZE_LATER("Gameplay Sample First Person (Replay Input)"),
+    .start = start_replay,
+    .stop = stop,
+    .tick = tick_replay,
+};
+
+// Hands the local player to a bot and adds more bots in stages, see `tick_stress()`.
+static tm_simulation_entry_i stress_simulation_entry_i = {
+    .id = TM_STATIC_HASH("tm_gameplay_sample_first_person_stress_simulate_entry_i", 0xe7afbaf4c062915aULL),
+    .display_name = TM_LOCALIZE_LATER("Gameplay Sample First Person (Stress Test)"),
+    .start = start_stress,
+    .stop = stop,
+    .tick = tick_stress,
+};
+
 TM_DLL_EXPORT void tm_load_plugin(struct tm_api_registry_api *reg, bool load)
 {
     tm_api_registry_api = reg;
@@ -722,6 +1342,12 @@ TM_DLL_EXPORT void tm_load_plugin(struct tm_api_registry_api *reg, bool load)
     tm_gamestate_api = tm_get_api(reg, tm_gamestate_api);
     tm_creation_graph_api = tm_get_api(reg, tm_creation_graph_api);
     tm_simulation_gamestate_api = tm_get_api(reg, tm_simulation_gamestate_api);
+    tm_logger_api = tm_get_api(reg, tm_logger_api);
+    tm_os_api = tm_get_api(reg, tm_os_api);
+    tm_profiler_api = tm_get_api(reg, tm_profiler_api);
 
     tm_add_or_remove_implementation(reg, load, tm_simulation_entry_i, &simulation_entry_i);
+    tm_add_or_remove_implementation(reg, load, tm_simulation_entry_i, &record_simulation_entry_i);
+    tm_add_or_remove_implementation(reg, load, tm_simulation_entry_i, &replay_simulation_entry_i);
+    tm_add_or_remove_implementation(reg, load, tm_simulation_entry_i, &stress_simulation_entry_i);
 }
\ No newline at end of file
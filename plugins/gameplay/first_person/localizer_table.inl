@@ -1,2 +1,5 @@
 {0},
     { .english = "Gameplay Sample First Person", .swedish = "" },
+    { .english = "Gameplay Sample First Person (Record Input)", .swedish = "" },
+    { .english = "Gameplay Sample First Person (Replay Input)", .swedish = "" },
+    { .english = "Gameplay Sample First Person (Stress Test)", .swedish = "" },
@@ -7,6 +7,8 @@ static struct tm_logger_api* tm_logger_api;
 static struct tm_transform_component_api* tm_transform_component_api;
 static struct tm_the_truth_common_types_api* tm_the_truth_common_types_api;
 static struct tm_simulation_gamestate_api* tm_simulation_gamestate_api;
+static struct tm_profiler_api* tm_profiler_api;
+static struct tm_os_api* tm_os_api;
 
 #include "interactable_component.h"
 
@@ -15,6 +17,8 @@ static struct tm_simulation_gamestate_api* tm_simulation_gamestate_api;
 #include <foundation/localizer.h>
 #include <foundation/log.h>
 #include <foundation/macros.h>
+#include <foundation/os.h>
+#include <foundation/profiler.h>
 #include <foundation/the_truth.h>
 #include <foundation/the_truth_types.h>
 #include <foundation/undo.h>
@@ -28,9 +32,15 @@ static struct tm_simulation_gamestate_api* tm_simulation_gamestate_api;
 #include <plugins/ui/ui.h>
 
 #include <foundation/carray.inl>
+#include <foundation/hash.inl>
 #include <foundation/math.inl>
 #include <foundation/rect.inl>
 
+#include "../../shared/blackboard_cache.inl"
+
+#include <float.h>
+#include <math.h>
+
 // ---
 
 // In most other parts of the engine these kind of property listings go in the header, but they aren't used anywhere
@@ -74,6 +84,8 @@ enum rotating_door_prop {
 };
 
 enum interactable_type {
+    // The component has no description (or hasn't been loaded yet), it doesn't animate anything.
+    INTERACTABLE_TYPE_NONE,
     INTERACTABLE_TYPE_LEVER,
     INTERACTABLE_TYPE_BUTTON,
     INTERACTABLE_TYPE_ROTATING_DOOR,
@@ -138,6 +150,53 @@ typedef struct interactable_component_t {
     };
 } interactable_component_t;
 
+// Gamestate representation of `interactable_component_t`. Only holds what changes while simulating, the
+// setup data (type, targets, rotations, positions and times) is constant and restored from the asset by
+// `component__asset_loaded` when the entity is spawned. Since the record only changes when the state enum
+// changes or an interaction starts or stops, unchanged interactables produce identical records.
+typedef struct {
+    // Start time of the active interaction, if `active` is set.
+    double start_time;
+
+    // enum lever_state, button_state or rotating_door_state, depending on the component type.
+    uint8_t state;
+    bool active;
+    bool target_activated;
+    TM_PAD(5);
+} interactable_gamestate_t;
+
+static uint32_t get_state(const interactable_component_t* c)
+{
+    switch (c->type) {
+    case INTERACTABLE_TYPE_NONE:
+        break;
+    case INTERACTABLE_TYPE_LEVER:
+        return c->lever.state;
+    case INTERACTABLE_TYPE_BUTTON:
+        return c->button.state;
+    case INTERACTABLE_TYPE_ROTATING_DOOR:
+        return c->rotating_door.state;
+    }
+    return 0;
+}
+
+static void set_state(interactable_component_t* c, uint32_t state)
+{
+    switch (c->type) {
+    case INTERACTABLE_TYPE_NONE:
+        break;
+    case INTERACTABLE_TYPE_LEVER: {
+        c->lever.state = (enum lever_state)state;
+    } break;
+    case INTERACTABLE_TYPE_BUTTON: {
+        c->button.state = (enum button_state)state;
+    } break;
+    case INTERACTABLE_TYPE_ROTATING_DOOR: {
+        c->rotating_door.state = (enum rotating_door_state)state;
+    } break;
+    }
+}
+
 // ---
 
 static const char* component_category(void)
@@ -156,43 +215,376 @@ typedef struct {
     TM_PAD(7);
 } active_interaction_t;
 
+// Activation requested by `interact()`. Activations are queued and turned into active interactions at the
+// start of the next `update_active_interactables()`.
+typedef struct {
+    // Simulation time of the activation. Becomes the start time of the active interaction.
+    double time;
+    tm_entity_t interactable;
+
+    // Set for interactions restored from a gamestate that already had activated their target.
+    bool target_activated;
+    TM_PAD(7);
+} activation_t;
+
+// Value in `active_lookup` for interactables that are queued, but not active yet.
+#define ACTIVATION_PENDING UINT32_MAX
+
+// Target chains longer than this are cut off, so a chain lookup is always bounded.
+#define MAX_TARGET_CHAIN_LENGTH 64
+
+// Room reserved in `chain_links` per interactable. Chains are usually a lever or button and a door or two.
+#define RESERVED_LINKS_PER_CHAIN 4
+
+// Flattened chain of targets of an interactable, i.e. its target, the target's target and so on.
+typedef struct {
+    // Range of the chain in `chain_links` of the manager.
+    uint32_t first_link;
+    uint32_t num_links;
+
+    // If set, this entity comes after the last link, but it isn't an interactable. An interactable
+    // can't be activated if its chain leads to such an entity.
+    tm_entity_t blocker;
+} target_chain_t;
+
+enum track_type {
+    TRACK_TYPE_NONE,
+    TRACK_TYPE_ROTATION,
+    TRACK_TYPE_POSITION,
+};
+
+// Interpolation tracks for everything the active interactions animate (lever handles, buttons and door
+// pivots), stored as structure-of-arrays. Track `i` belongs to `active[i]` of the manager, they are always
+// added and removed together. All arrays live in the single allocation `buffer`, see `track_columns`.
+typedef struct {
+    // Entity whose local transform is animated.
+    tm_entity_t* entity;
+    uint32_t* type; // enum track_type
+    double* start_time;
+    float* duration;
+    tm_vec4_t* from_rot;
+    tm_vec4_t* to_rot;
+    tm_vec3_t* from_pos;
+    tm_vec3_t* to_pos;
+
+    // Output of `evaluate_tracks()`.
+    float* progress;
+    tm_vec4_t* rot;
+    tm_vec3_t* pos;
+
+    // Number of tracks and the number of tracks `buffer` has room for.
+    uint32_t n;
+    uint32_t capacity;
+    void* buffer;
+    uint64_t buffer_size;
+} interpolation_tracks_t;
+
+// Array of `interpolation_tracks_t`: offset of the array pointer in the struct and size of its elements.
+typedef struct {
+    uint32_t offset;
+    uint32_t size;
+} track_column_t;
+
+#define TRACK_COLUMN(name) { offsetof(interpolation_tracks_t, name), sizeof(*((interpolation_tracks_t*)0)->name) }
+
+static const track_column_t track_columns[] = {
+    TRACK_COLUMN(entity),
+    TRACK_COLUMN(type),
+    TRACK_COLUMN(start_time),
+    TRACK_COLUMN(duration),
+    TRACK_COLUMN(from_rot),
+    TRACK_COLUMN(to_rot),
+    TRACK_COLUMN(from_pos),
+    TRACK_COLUMN(to_pos),
+    TRACK_COLUMN(progress),
+    TRACK_COLUMN(rot),
+    TRACK_COLUMN(pos),
+};
+
+// Tracks never run shorter than this, so that evaluating them doesn't divide by zero.
+#define MIN_TRACK_DURATION 0.001f
+
+// Everything `component__asset_loaded` reads from The Truth for an entity asset with an interactable
+// component. Cached per entity asset, so spawning another instance of the same asset only needs to resolve
+// the entity references and read the transform of the animated entity.
+typedef struct {
+    // Objects this was read from and their versions at the time, used to detect changes.
+    uint64_t entity_asset_version;
+    tm_tt_id_t asset;
+    uint64_t asset_version;
+    tm_tt_id_t desc;
+    uint64_t desc_version;
+
+    tm_strhash_t desc_type_hash;
+    tm_tt_id_t target;
+    float target_activation_delay;
+    bool player_can_activate;
+    TM_PAD(3);
+
+    // Entity animated by the interactable: lever handle, button or door pivot.
+    tm_tt_id_t animated;
+
+    // Rotation applied to open levers and doors.
+    tm_vec4_t rotation;
+
+    // Offset applied to push buttons.
+    tm_vec3_t offset;
+
+    // Open, push or rotate time.
+    float time;
+} interactable_descriptor_t;
+
+// Side of the cells in the spatial index of interactables, in meters. Interaction queries have a radius of a
+// few meters, so a query touches at most a handful of cells.
+#define INTERACTABLE_GRID_CELL_SIZE 4.0f
+
+// Position of an interactable in the spatial index.
+typedef struct spatial_entry_t {
+    tm_entity_t entity;
+    tm_vec3_t pos;
+
+    // Version of the transform component `pos` was read from.
+    uint32_t version;
+
+    // Index into `grid_cells`.
+    uint32_t cell;
+    TM_PAD(4);
+} spatial_entry_t;
+
+// Range of `grid_entries` that holds the interactables of one grid cell.
+typedef struct grid_cell_t {
+    uint32_t first;
+    uint32_t count;
+} grid_cell_t;
+
 struct tm_interactable_component_manager_o {
     tm_allocator_i allocator;
     tm_entity_context_o* ctx;
     active_interaction_t* active;
+    interpolation_tracks_t tracks;
+
+    // Double-buffered activation queue. `interact()` pushes to `activations[write_activations]`. The update
+    // swaps the buffers and drains the other one, so activations made while updating (chain activations)
+    // are drained by the next update, in the order they were made.
+    activation_t* activations[2];
+    uint32_t write_activations;
+    TM_PAD(4);
+
+    // Simulation time of the most recent update, used to timestamp activations.
+    double time;
+
+    // Maps an interactable entity to its index in `active` (or `ACTIVATION_PENDING` if it is queued), so that
+    // we can check if an interactable is already doing something without scanning `active`.
+    struct TM_HASH_T(uint64_t, uint32_t) active_lookup;
+
+    // Target chains are flattened the first time they are needed and cached here. They are thrown
+    // away when `chains_dirty` is set, which happens whenever an interactable is added, removed, loaded or
+    // restored from a gamestate.
+    target_chain_t* chains;
+    tm_entity_t* chain_links;
+    struct TM_HASH_T(uint64_t, uint32_t) chain_lookup;
+    bool chains_dirty;
+    TM_PAD(7);
+
+    // Cache of the data read by `component__asset_loaded`, keyed by entity asset.
+    interactable_descriptor_t* descriptors;
+    struct TM_HASH_T(uint64_t, uint32_t) descriptor_lookup;
+    tm_tt_type_t interactable_tt_type;
+
+    // Spatial index of all interactables, used by `find_interactable()`. It is a uniform grid: `grid_lookup`
+    // maps a cell key to an index in `grid_cells`, which points out a range of `grid_entries`, which are
+    // indices into `spatial`. The engine refreshes `spatial` from the transform versions every update and
+    // rebuilds the grid only if something moved, appeared or disappeared.
+    spatial_entry_t* spatial;
+    grid_cell_t* grid_cells;
+    uint32_t* grid_entries;
+    struct TM_HASH_T(uint64_t, uint32_t) grid_lookup;
+
     tm_component_type_t interactable_component_type;
     tm_component_type_t transform_component_type;
     tm_transform_component_manager_o* trans_mgr;
+
+    // Reported by `stats()`.
+    uint64_t total_updates;
+    uint64_t total_activations;
+    uint64_t total_can_interact_calls;
+    double last_update_seconds;
+    uint32_t peak_active;
+    uint32_t peak_queued;
+
+    // Number of interactables the per-interactable arrays have been reserved for, see `reserve_capacity()`.
+    uint32_t capacity;
+    TM_PAD(4);
+
+    // Blackboard values read by the engine, indexed by `enum interactable_bb`.
+    blackboard_cache_t blackboard;
+
+    // If set, the engine updates with `clock_time` and `clock_dt` instead of the blackboard time, see
+    // `set_clock()`.
+    bool use_clock;
+    TM_PAD(3);
+    float clock_dt;
+    double clock_time;
 };
 
 static void interact(tm_interactable_component_manager_o* mgr, tm_entity_t interactable);
 static bool can_interact(tm_interactable_component_manager_o* mgr, tm_entity_t interactable, bool is_player);
 
+static char** track_column(interpolation_tracks_t* tr, uint32_t col)
+{
+    return (char**)((char*)tr + track_columns[col].offset);
+}
+
+// Moves the tracks to a new buffer with room for `capacity` tracks. Each array starts at a 16 byte boundary.
+static void set_track_capacity(interpolation_tracks_t* tr, uint32_t capacity, tm_allocator_i* a)
+{
+    uint64_t size = 0;
+    for (uint32_t col = 0; col < TM_ARRAY_COUNT(track_columns); ++col)
+        size += ((uint64_t)track_columns[col].size * capacity + 15) & ~15ULL;
+
+    char* buffer = size ? tm_alloc(a, size) : 0;
+    uint64_t offset = 0;
+    for (uint32_t col = 0; col < TM_ARRAY_COUNT(track_columns); ++col) {
+        char** column = track_column(tr, col);
+        if (tr->n)
+            memcpy(buffer + offset, *column, (uint64_t)track_columns[col].size * tr->n);
+        *column = buffer + offset;
+        offset += ((uint64_t)track_columns[col].size * capacity + 15) & ~15ULL;
+    }
+
+    if (tr->buffer)
+        tm_free(a, tr->buffer, tr->buffer_size);
+    tr->buffer = buffer;
+    tr->buffer_size = size;
+    tr->capacity = capacity;
+}
+
+// Adds a track that doesn't animate anything.
+static void push_track(interpolation_tracks_t* tr, tm_allocator_i* a)
+{
+    if (tr->n == tr->capacity)
+        set_track_capacity(tr, tm_max(2 * tr->capacity, 16u), a);
+
+    const uint32_t idx = tr->n++;
+    for (uint32_t col = 0; col < TM_ARRAY_COUNT(track_columns); ++col)
+        memset(*track_column(tr, col) + (uint64_t)track_columns[col].size * idx, 0, track_columns[col].size);
+
+    tr->type[idx] = TRACK_TYPE_NONE;
+    tr->duration[idx] = 1.0f;
+    tr->from_rot[idx] = tr->to_rot[idx] = tr->rot[idx] = (tm_vec4_t){ 0, 0, 0, 1 };
+}
+
+static void move_track(interpolation_tracks_t* tr, uint32_t from, uint32_t to)
+{
+    for (uint32_t col = 0; col < TM_ARRAY_COUNT(track_columns); ++col) {
+        char* column = *track_column(tr, col);
+        const uint32_t size = track_columns[col].size;
+        memcpy(column + (uint64_t)size * to, column + (uint64_t)size * from, size);
+    }
+}
+
+static void shrink_tracks(interpolation_tracks_t* tr, uint32_t n)
+{
+    tr->n = tm_min(tr->n, n);
+}
+
+static void reserve_tracks(interpolation_tracks_t* tr, uint32_t n, tm_allocator_i* a)
+{
+    if (n > tr->capacity)
+        set_track_capacity(tr, n, a);
+}
+
+static void free_tracks(interpolation_tracks_t* tr, tm_allocator_i* a)
+{
+    if (tr->buffer)
+        tm_free(a, tr->buffer, tr->buffer_size);
+    *tr = (interpolation_tracks_t){ 0 };
+}
+
+// Every track that animates something is set up through here. The duration is clamped, since it comes from
+// component data that may have been restored from a gamestate rather than read by `component__asset_loaded`.
+static void set_track(interpolation_tracks_t* tr, uint32_t idx, enum track_type type, tm_entity_t e, double start_time, float duration)
+{
+    tr->entity[idx] = e;
+    tr->type[idx] = type;
+    tr->start_time[idx] = start_time;
+    tr->duration[idx] = tm_max(duration, MIN_TRACK_DURATION);
+    tr->progress[idx] = 0.0f;
+}
+
+static void set_rotation_track(interpolation_tracks_t* tr, uint32_t idx, tm_entity_t e, double start_time, float duration, tm_vec4_t from, tm_vec4_t to)
+{
+    set_track(tr, idx, TRACK_TYPE_ROTATION, e, start_time, duration);
+    tr->from_rot[idx] = from;
+    tr->to_rot[idx] = to;
+}
+
+static void set_position_track(interpolation_tracks_t* tr, uint32_t idx, tm_entity_t e, double start_time, float duration, tm_vec3_t from, tm_vec3_t to)
+{
+    set_track(tr, idx, TRACK_TYPE_POSITION, e, start_time, duration);
+    tr->from_pos[idx] = from;
+    tr->to_pos[idx] = to;
+}
+
+// Evaluates all tracks at time `t`. Each loop only touches a few flat arrays and has no branches, so the
+// compiler can vectorize them. Tracks of type `TRACK_TYPE_NONE` are evaluated too, they interpolate
+// between identity values and the result is ignored.
+static void evaluate_tracks(interpolation_tracks_t* tr, uint32_t n, double t)
+{
+    for (uint32_t i = 0; i < n; ++i)
+        tr->progress[i] = tm_min((float)(t - tr->start_time[i]) / tr->duration[i], 1.0f);
+
+    for (uint32_t i = 0; i < n; ++i)
+        tr->rot[i] = tm_quaternion_nlerp(tr->from_rot[i], tr->to_rot[i], tr->progress[i]);
+
+    for (uint32_t i = 0; i < n; ++i)
+        tr->pos[i] = tm_vec3_lerp(tr->from_pos[i], tr->to_pos[i], tr->progress[i]);
+}
+
+// Writes the result of `evaluate_tracks()` to the transforms of the animated entities.
+static void write_tracks(tm_transform_component_manager_o* trans_mgr, const interpolation_tracks_t* tr, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i) {
+        if (!tr->entity[i].u64)
+            continue;
+
+        if (tr->type[i] == TRACK_TYPE_ROTATION)
+            tm_set_local_rotation(trans_mgr, tr->entity[i], tr->rot[i]);
+        else if (tr->type[i] == TRACK_TYPE_POSITION)
+            tm_set_local_position(trans_mgr, tr->entity[i], tr->pos[i]);
+    }
+}
+
+// Queues activation of the target of the interactable at `active_idx`.
+static void activate_target(tm_interactable_component_manager_o* mgr, uint32_t active_idx, tm_entity_t target)
+{
+    interact(mgr, target);
+    mgr->active[active_idx].target_activated = true;
+}
+
 // State machine for lever
-static bool update_lever(tm_interactable_component_manager_o* mgr, float dt, double t, active_interaction_t* a,
+static bool update_lever(tm_interactable_component_manager_o* mgr, uint32_t active_idx,
     interactable_component_t* c, bool can_activate_target)
 {
     bool res = false;
     lever_t* l = &c->lever;
+    interpolation_tracks_t* tr = &mgr->tracks;
+    const double start_time = mgr->active[active_idx].start_time;
+
     switch (l->state) {
     case LEVER_STATE_CLOSED: {
         l->state = LEVER_STATE_LEVER_OPENING;
+        set_rotation_track(tr, active_idx, l->handle, start_time, l->handle_open_time, l->handle_closed_rotation, l->handle_open_rotation);
     } break;
 
     case LEVER_STATE_LEVER_OPENING: {
-        const float p = (float)(t - a->start_time) / l->handle_open_time;
-        const tm_vec4_t rot = tm_quaternion_nlerp(l->handle_closed_rotation, l->handle_open_rotation, tm_min(p, 1));
-        tm_set_local_rotation(mgr->trans_mgr, l->handle, rot);
-
-        if (p >= 1) {
+        if (tr->progress[active_idx] >= 1) {
             l->state = LEVER_STATE_OPEN;
 
             // If target of this lever hasn't been activated by auto-acitvation yet, then activate it now, since
             // we are done animating.
-            if (can_activate_target && can_interact(mgr, c->target, false)) {
-                interact(mgr, c->target);
-                a->target_activated = true;
-            }
+            if (can_activate_target && can_interact(mgr, c->target, false))
+                activate_target(mgr, active_idx, c->target);
 
             res = true;
         }
@@ -200,20 +592,15 @@ static bool update_lever(tm_interactable_component_manager_o* mgr, float dt, dou
 
     case LEVER_STATE_OPEN: {
         l->state = LEVER_STATE_LEVER_CLOSING;
+        set_rotation_track(tr, active_idx, l->handle, start_time, l->handle_open_time, l->handle_open_rotation, l->handle_closed_rotation);
     } break;
 
     case LEVER_STATE_LEVER_CLOSING: {
-        const float p = (float)(t - a->start_time) / l->handle_open_time;
-        const tm_vec4_t rot = tm_quaternion_nlerp(l->handle_open_rotation, l->handle_closed_rotation, tm_min(p, 1));
-        tm_set_local_rotation(mgr->trans_mgr, l->handle, rot);
-
-        if (p >= 1) {
+        if (tr->progress[active_idx] >= 1) {
             l->state = LEVER_STATE_CLOSED;
 
-            if (can_activate_target && can_interact(mgr, c->target, false)) {
-                interact(mgr, c->target);
-                a->target_activated = true;
-            }
+            if (can_activate_target && can_interact(mgr, c->target, false))
+                activate_target(mgr, active_idx, c->target);
 
             res = true;
         }
@@ -224,28 +611,26 @@ static bool update_lever(tm_interactable_component_manager_o* mgr, float dt, dou
 }
 
 // State machine for button
-static bool update_button(tm_interactable_component_manager_o* mgr, float dt, double t, active_interaction_t* a,
+static bool update_button(tm_interactable_component_manager_o* mgr, uint32_t active_idx,
     interactable_component_t* c, bool can_activate_target)
 {
     bool res = false;
     button_t* b = &c->button;
+    interpolation_tracks_t* tr = &mgr->tracks;
+    const double start_time = mgr->active[active_idx].start_time;
+
     switch (b->state) {
     case BUTTON_STATE_NORMAL: {
         b->state = BUTTON_STATE_BUTTON_PUSHING;
+        set_position_track(tr, active_idx, b->button, start_time, b->button_push_time, b->button_normal_position, b->button_pushed_position);
     } break;
 
     case BUTTON_STATE_BUTTON_PUSHING: {
-        const float p = (float)(t - a->start_time) / b->button_push_time;
-        const tm_vec3_t pos = tm_vec3_lerp(b->button_normal_position, b->button_pushed_position, tm_min(p, 1));
-        tm_set_local_position(mgr->trans_mgr, b->button, pos);
-
-        if (p >= 1) {
+        if (tr->progress[active_idx] >= 1) {
             res = true;
 
-            if (can_activate_target && can_interact(mgr, c->target, false)) {
-                interact(mgr, c->target);
-                a->target_activated = true;
-            }
+            if (can_activate_target && can_interact(mgr, c->target, false))
+                activate_target(mgr, active_idx, c->target);
 
             b->state = BUTTON_STATE_PUSHED;
         }
@@ -253,20 +638,15 @@ static bool update_button(tm_interactable_component_manager_o* mgr, float dt, do
 
     case BUTTON_STATE_PUSHED: {
         b->state = BUTTON_STATE_BUTTON_UNPUSHING;
+        set_position_track(tr, active_idx, b->button, start_time, b->button_push_time, b->button_pushed_position, b->button_normal_position);
     } break;
 
     case BUTTON_STATE_BUTTON_UNPUSHING: {
-        const float p = (float)(t - a->start_time) / b->button_push_time;
-        const tm_vec3_t pos = tm_vec3_lerp(b->button_pushed_position, b->button_normal_position, tm_min(p, 1));
-        tm_set_local_position(mgr->trans_mgr, b->button, pos);
-
-        if (p >= 1) {
+        if (tr->progress[active_idx] >= 1) {
             res = true;
 
-            if (can_activate_target && can_interact(mgr, c->target, false)) {
-                interact(mgr, c->target);
-                a->target_activated = true;
-            }
+            if (can_activate_target && can_interact(mgr, c->target, false))
+                activate_target(mgr, active_idx, c->target);
 
             b->state = BUTTON_STATE_NORMAL;
         }
@@ -277,21 +657,21 @@ static bool update_button(tm_interactable_component_manager_o* mgr, float dt, do
 }
 
 // State machine for door
-static bool update_rotating_door(tm_interactable_component_manager_o* mgr, float dt, double t, active_interaction_t* a, interactable_component_t* c)
+static bool update_rotating_door(tm_interactable_component_manager_o* mgr, uint32_t active_idx, interactable_component_t* c)
 {
     bool res = false;
     rotating_door_t* s = &c->rotating_door;
+    interpolation_tracks_t* tr = &mgr->tracks;
+    const double start_time = mgr->active[active_idx].start_time;
+
     switch (s->state) {
     case ROTATING_DOOR_STATE_CLOSED: {
         s->state = ROTATING_DOOR_STATE_OPENING;
+        set_rotation_track(tr, active_idx, s->pivot, start_time, s->pivot_rotate_time, s->pivot_closed_rotation, s->pivot_open_rotation);
     } break;
 
     case ROTATING_DOOR_STATE_OPENING: {
-        const float p = (float)(t - a->start_time) / s->pivot_rotate_time;
-        const tm_vec4_t rot = tm_quaternion_nlerp(s->pivot_closed_rotation, s->pivot_open_rotation, tm_min(p, 1));
-        tm_set_local_rotation(mgr->trans_mgr, s->pivot, rot);
-
-        if (p >= 1) {
+        if (tr->progress[active_idx] >= 1) {
             res = true;
             s->state = ROTATING_DOOR_STATE_OPEN;
         }
@@ -299,14 +679,11 @@ static bool update_rotating_door(tm_interactable_component_manager_o* mgr, float
 
     case ROTATING_DOOR_STATE_OPEN: {
         s->state = ROTATING_DOOR_STATE_CLOSING;
+        set_rotation_track(tr, active_idx, s->pivot, start_time, s->pivot_rotate_time, s->pivot_open_rotation, s->pivot_closed_rotation);
     } break;
 
     case ROTATING_DOOR_STATE_CLOSING: {
-        const float p = (float)(t - a->start_time) / s->pivot_rotate_time;
-        const tm_vec4_t rot = tm_quaternion_nlerp(s->pivot_open_rotation, s->pivot_closed_rotation, tm_min(p, 1));
-        tm_set_local_rotation(mgr->trans_mgr, s->pivot, rot);
-
-        if (p >= 1) {
+        if (tr->progress[active_idx] >= 1) {
             res = true;
             s->state = ROTATING_DOOR_STATE_CLOSED;
         }
@@ -316,15 +693,94 @@ static bool update_rotating_door(tm_interactable_component_manager_o* mgr, float
     return res;
 }
 
+// Sets up the track of the active interaction at `active_idx` if its interactable is in the middle of
+// animating. This only happens for interactions restored from a gamestate, regular activations start out in
+// a resting state and set up their tracks in the state machines.
+static void restore_track(tm_interactable_component_manager_o* mgr, uint32_t active_idx, const interactable_component_t* c)
+{
+    interpolation_tracks_t* tr = &mgr->tracks;
+    const double start_time = mgr->active[active_idx].start_time;
+
+    switch (c->type) {
+    case INTERACTABLE_TYPE_NONE:
+        break;
+    case INTERACTABLE_TYPE_LEVER: {
+        const lever_t* l = &c->lever;
+        if (l->state == LEVER_STATE_LEVER_OPENING)
+            set_rotation_track(tr, active_idx, l->handle, start_time, l->handle_open_time, l->handle_closed_rotation, l->handle_open_rotation);
+        else if (l->state == LEVER_STATE_LEVER_CLOSING)
+            set_rotation_track(tr, active_idx, l->handle, start_time, l->handle_open_time, l->handle_open_rotation, l->handle_closed_rotation);
+    } break;
+    case INTERACTABLE_TYPE_BUTTON: {
+        const button_t* b = &c->button;
+        if (b->state == BUTTON_STATE_BUTTON_PUSHING)
+            set_position_track(tr, active_idx, b->button, start_time, b->button_push_time, b->button_normal_position, b->button_pushed_position);
+        else if (b->state == BUTTON_STATE_BUTTON_UNPUSHING)
+            set_position_track(tr, active_idx, b->button, start_time, b->button_push_time, b->button_pushed_position, b->button_normal_position);
+    } break;
+    case INTERACTABLE_TYPE_ROTATING_DOOR: {
+        const rotating_door_t* s = &c->rotating_door;
+        if (s->state == ROTATING_DOOR_STATE_OPENING)
+            set_rotation_track(tr, active_idx, s->pivot, start_time, s->pivot_rotate_time, s->pivot_closed_rotation, s->pivot_open_rotation);
+        else if (s->state == ROTATING_DOOR_STATE_CLOSING)
+            set_rotation_track(tr, active_idx, s->pivot, start_time, s->pivot_rotate_time, s->pivot_open_rotation, s->pivot_closed_rotation);
+    } break;
+    }
+}
+
+// Turns the activations queued since the last update into active interactions, in the order they were
+// queued.
+static void drain_activations(tm_interactable_component_manager_o* mgr)
+{
+    const activation_t* activations = mgr->activations[mgr->write_activations];
+    mgr->write_activations ^= 1;
+    tm_carray_resize(mgr->activations[mgr->write_activations], 0, &mgr->allocator);
+
+    for (const activation_t* act = activations; act != tm_carray_end(activations); ++act) {
+        const interactable_component_t* c = tm_entity_api->read_component(mgr->ctx, act->interactable, mgr->interactable_component_type);
+
+        if (!c) {
+            tm_hash_remove(&mgr->active_lookup, act->interactable.u64);
+            continue;
+        }
+
+        const uint32_t active_idx = (uint32_t)tm_carray_size(mgr->active);
+        tm_hash_add(&mgr->active_lookup, act->interactable.u64, active_idx);
+        tm_carray_push(mgr->active, ((active_interaction_t){ .start_time = act->time, .interactable = act->interactable, .target_activated = act->target_activated }), &mgr->allocator);
+        push_track(&mgr->tracks, &mgr->allocator);
+        restore_track(mgr, active_idx, c);
+    }
+
+    mgr->peak_active = tm_max(mgr->peak_active, (uint32_t)tm_carray_size(mgr->active));
+}
+
 // Goes through all interactables that are active (doing something, such as animating etc) and updates them.
 static void update_active_interactables(tm_interactable_component_manager_o* mgr, float dt, double t)
 {
-    for (int32_t active_idx = 0; active_idx < (int32_t)tm_carray_size(mgr->active); ++active_idx) {
+    TM_PROFILER_BEGIN_FUNC_SCOPE();
+    const tm_clock_o start = tm_os_api->time->now();
+
+    mgr->time = t;
+    drain_activations(mgr);
+
+    // Animate everything in one go, the state machines below only look at the resulting progress.
+    const uint32_t num_active = (uint32_t)tm_carray_size(mgr->active);
+    evaluate_tracks(&mgr->tracks, num_active, t);
+    write_tracks(mgr->trans_mgr, &mgr->tracks, num_active);
+
+    // Activations made here are queued, so `mgr->active` doesn't change while we iterate it. Finished
+    // interactions are compacted away without reordering the rest, so interactions are always processed in
+    // the order they were activated.
+    uint32_t num_kept = 0;
+    for (uint32_t active_idx = 0; active_idx < num_active; ++active_idx) {
         active_interaction_t* a = mgr->active + active_idx;
         interactable_component_t* c = tm_entity_api->write_component(mgr->ctx, a->interactable, mgr->interactable_component_type);
 
-        if (!a->start_time)
-            a->start_time = t;
+        // The interactable was destroyed (or lost its component) while active, drop the interaction.
+        if (!c) {
+            tm_hash_remove(&mgr->active_lookup, a->interactable.u64);
+            continue;
+        }
 
         // An interactable can chain-activate another one (which is what button and levers do, but doors can do this
         // to if you wish...)
@@ -332,26 +788,44 @@ static void update_active_interactables(tm_interactable_component_manager_o* mgr
 
         if (tm_entity_api->is_alive(mgr->ctx, c->target) && !a->target_activated && auto_activate_target
             && (t - a->start_time) >= c->target_activation_delay && can_interact(mgr, c->target, false)) {
-            a->target_activated = true;
-            interact(mgr, c->target);
+            activate_target(mgr, active_idx, c->target);
         }
 
         bool res = false;
         switch (c->type) {
+        case INTERACTABLE_TYPE_NONE: {
+            res = true;
+        } break;
         case INTERACTABLE_TYPE_LEVER: {
-            res = update_lever(mgr, dt, t, a, c, !auto_activate_target);
+            res = update_lever(mgr, active_idx, c, !auto_activate_target);
         } break;
         case INTERACTABLE_TYPE_BUTTON: {
-            res = update_button(mgr, dt, t, a, c, !auto_activate_target);
+            res = update_button(mgr, active_idx, c, !auto_activate_target);
         } break;
         case INTERACTABLE_TYPE_ROTATING_DOOR: {
-            res = update_rotating_door(mgr, dt, t, a, c);
+            res = update_rotating_door(mgr, active_idx, c);
         } break;
         }
 
-        if (res)
-            mgr->active[active_idx--] = tm_carray_pop(mgr->active);
+        if (res) {
+            tm_hash_remove(&mgr->active_lookup, a->interactable.u64);
+            continue;
+        }
+
+        if (num_kept != active_idx) {
+            mgr->active[num_kept] = *a;
+            move_track(&mgr->tracks, active_idx, num_kept);
+            tm_hash_add(&mgr->active_lookup, a->interactable.u64, num_kept);
+        }
+        ++num_kept;
     }
+
+    tm_carray_resize(mgr->active, num_kept, &mgr->allocator);
+    shrink_tracks(&mgr->tracks, num_kept);
+
+    ++mgr->total_updates;
+    mgr->last_update_seconds = tm_os_api->time->delta(tm_os_api->time->now(), start);
+    TM_PROFILER_END_FUNC_SCOPE();
 }
 
 static void manager_init(tm_interactable_component_manager_o* mgr)
@@ -360,19 +834,112 @@ static void manager_init(tm_interactable_component_manager_o* mgr)
     mgr->trans_mgr = (tm_transform_component_manager_o*)tm_entity_api->component_manager(mgr->ctx, mgr->transform_component_type);
 }
 
+// Reserves room for `n` interactables in everything that holds at most one entry per interactable, and in
+// the chain cache, which holds at most one chain per interactable. An interactable can only be queued or
+// active once at a time, so after this, activating and finishing interactions never allocates, as long as
+// the cached chains are at most `RESERVED_LINKS_PER_CHAIN` links long on average.
+static void reserve_capacity(tm_interactable_component_manager_o* mgr, uint32_t n)
+{
+    if (n <= mgr->capacity)
+        return;
+
+    tm_carray_ensure(mgr->active, n, &mgr->allocator);
+    reserve_tracks(&mgr->tracks, n, &mgr->allocator);
+    tm_carray_ensure(mgr->activations[0], n, &mgr->allocator);
+    tm_carray_ensure(mgr->activations[1], n, &mgr->allocator);
+    tm_hash_reserve(&mgr->active_lookup, n);
+    tm_carray_ensure(mgr->spatial, n, &mgr->allocator);
+    tm_carray_ensure(mgr->grid_cells, n, &mgr->allocator);
+    tm_carray_ensure(mgr->grid_entries, n, &mgr->allocator);
+    tm_hash_reserve(&mgr->grid_lookup, n);
+    tm_carray_ensure(mgr->chains, n, &mgr->allocator);
+    tm_carray_ensure(mgr->chain_links, n * RESERVED_LINKS_PER_CHAIN, &mgr->allocator);
+    tm_hash_reserve(&mgr->chain_lookup, n);
+    mgr->capacity = n;
+}
+
 static void manager_deinit(tm_interactable_component_manager_o* mgr)
 {
     tm_carray_free(mgr->active, &mgr->allocator);
+    free_tracks(&mgr->tracks, &mgr->allocator);
+    tm_carray_free(mgr->activations[0], &mgr->allocator);
+    tm_carray_free(mgr->activations[1], &mgr->allocator);
+    tm_hash_free(&mgr->active_lookup);
+    tm_carray_free(mgr->chains, &mgr->allocator);
+    tm_carray_free(mgr->chain_links, &mgr->allocator);
+    tm_hash_free(&mgr->chain_lookup);
+    tm_carray_free(mgr->spatial, &mgr->allocator);
+    tm_carray_free(mgr->grid_cells, &mgr->allocator);
+    tm_carray_free(mgr->grid_entries, &mgr->allocator);
+    tm_hash_free(&mgr->grid_lookup);
+    tm_carray_free(mgr->descriptors, &mgr->allocator);
+    tm_hash_free(&mgr->descriptor_lookup);
 }
 
-// Push the entity on a list, it's processed in `update_active_interactables` later.
+// Queues the entity for activation, it's processed in `update_active_interactables` later. The activation is
+// timestamped with the simulation time of the most recent update. Does nothing if the interactable already
+// is active or queued.
 static void interact(tm_interactable_component_manager_o* mgr, tm_entity_t interactable)
 {
-    tm_carray_push(mgr->active, ((active_interaction_t){ .interactable = interactable }), &mgr->allocator);
+    if (tm_hash_has(&mgr->active_lookup, interactable.u64))
+        return;
+
+    tm_hash_add(&mgr->active_lookup, interactable.u64, ACTIVATION_PENDING);
+    tm_carray_push(mgr->activations[mgr->write_activations], ((activation_t){ .time = mgr->time, .interactable = interactable }), &mgr->allocator);
+    ++mgr->total_activations;
+    mgr->peak_queued = tm_max(mgr->peak_queued, (uint32_t)tm_carray_size(mgr->activations[mgr->write_activations]));
+}
+
+// Returns the flattened target chain of `interactable`, building it if it isn't cached. The chain stops at
+// the first entity that is dead, isn't an interactable or already is part of the chain (a cycle).
+static const target_chain_t* resolve_target_chain(tm_interactable_component_manager_o* mgr, tm_entity_t interactable, const interactable_component_t* c)
+{
+    if (mgr->chains_dirty) {
+        tm_carray_resize(mgr->chains, 0, &mgr->allocator);
+        tm_carray_resize(mgr->chain_links, 0, &mgr->allocator);
+        tm_hash_clear(&mgr->chain_lookup);
+        mgr->chains_dirty = false;
+    }
+
+    const uint32_t cached_idx = tm_hash_get_default(&mgr->chain_lookup, interactable.u64, UINT32_MAX);
+
+    if (cached_idx != UINT32_MAX)
+        return mgr->chains + cached_idx;
+
+    target_chain_t chain = { .first_link = (uint32_t)tm_carray_size(mgr->chain_links) };
+
+    for (tm_entity_t link = c->target; tm_entity_api->is_alive(mgr->ctx, link);) {
+        bool is_cycle = link.u64 == interactable.u64;
+
+        for (uint32_t i = 0; i < chain.num_links && !is_cycle; ++i)
+            is_cycle = mgr->chain_links[chain.first_link + i].u64 == link.u64;
+
+        if (is_cycle || chain.num_links == MAX_TARGET_CHAIN_LENGTH) {
+            tm_logger_api->printf(TM_LOG_TYPE_ERROR, "Interactable target chain %s, stopping after %u links.\n", is_cycle ? "contains a cycle" : "is too long", chain.num_links);
+            break;
+        }
+
+        const interactable_component_t* link_c = tm_entity_api->read_component(mgr->ctx, link, mgr->interactable_component_type);
+
+        if (!link_c) {
+            chain.blocker = link;
+            break;
+        }
+
+        tm_carray_push(mgr->chain_links, link, &mgr->allocator);
+        ++chain.num_links;
+        link = link_c->target;
+    }
+
+    tm_hash_add(&mgr->chain_lookup, interactable.u64, (uint32_t)tm_carray_size(mgr->chains));
+    tm_carray_push(mgr->chains, chain, &mgr->allocator);
+    return mgr->chains + tm_carray_size(mgr->chains) - 1;
 }
 
 static bool can_interact(tm_interactable_component_manager_o* mgr, tm_entity_t interactable, bool is_player)
 {
+    ++mgr->total_can_interact_calls;
+
     if (!tm_entity_api->is_alive(mgr->ctx, interactable))
         return false;
 
@@ -384,25 +951,164 @@ static bool can_interact(tm_interactable_component_manager_o* mgr, tm_entity_t i
     if (is_player && !c->player_can_activate)
         return false;
 
-    // Send is_player false here. This check is for check if this component can interact with another one, as a chain.
-    if (tm_entity_api->is_alive(mgr->ctx, c->target) && !can_interact(mgr, c->target, false))
+    // Make sure this interactable component isn't already doing something.
+    if (tm_hash_has(&mgr->active_lookup, interactable.u64))
         return false;
 
-    // Make sure this interactable component isn't already doing something.
-    for (int32_t active_idx = 0; active_idx < (int32_t)tm_carray_size(mgr->active); ++active_idx) {
-        active_interaction_t* a = mgr->active + active_idx;
+    // Check the targets, as a chain. Player activation doesn't matter for them, they are activated by the
+    // interactable in front of them.
+    const target_chain_t* chain = resolve_target_chain(mgr, interactable, c);
 
-        if (a->interactable.u64 == interactable.u64)
+    for (uint32_t i = 0; i < chain->num_links; ++i) {
+        const tm_entity_t link = mgr->chain_links[chain->first_link + i];
+
+        // The chain ends at a dead entity, nothing after it will be activated.
+        if (!tm_entity_api->is_alive(mgr->ctx, link))
+            return true;
+
+        if (tm_hash_has(&mgr->active_lookup, link.u64))
             return false;
     }
 
-    return true;
+    return !tm_entity_api->is_alive(mgr->ctx, chain->blocker);
+}
+
+// Packs the grid coordinates `x`, `y`, `z` into a hash key. 21 bits per axis, offset by one so that the key
+// never collides with the reserved hash keys.
+static uint64_t grid_cell_key(int32_t x, int32_t y, int32_t z)
+{
+    const uint64_t mask = (1ULL << 21) - 1;
+    return ((((uint64_t)x & mask) << 42) | (((uint64_t)y & mask) << 21) | ((uint64_t)z & mask)) + 1;
+}
+
+static int32_t grid_coord(float v)
+{
+    return (int32_t)floorf(v / INTERACTABLE_GRID_CELL_SIZE);
+}
+
+// Buckets the entries of `mgr->spatial` into the grid: count the entries of each cell, turn the counts into
+// ranges and scatter the entry indices into their ranges.
+static void rebuild_grid(tm_interactable_component_manager_o* mgr)
+{
+    const uint32_t n = (uint32_t)tm_carray_size(mgr->spatial);
+    tm_hash_clear(&mgr->grid_lookup);
+    tm_carray_resize(mgr->grid_cells, 0, &mgr->allocator);
+    tm_carray_resize(mgr->grid_entries, n, &mgr->allocator);
+
+    for (spatial_entry_t* s = mgr->spatial; s != tm_carray_end(mgr->spatial); ++s) {
+        const uint64_t key = grid_cell_key(grid_coord(s->pos.x), grid_coord(s->pos.y), grid_coord(s->pos.z));
+        s->cell = tm_hash_get_default(&mgr->grid_lookup, key, UINT32_MAX);
+        if (s->cell == UINT32_MAX) {
+            s->cell = (uint32_t)tm_carray_size(mgr->grid_cells);
+            tm_hash_add(&mgr->grid_lookup, key, s->cell);
+            tm_carray_push(mgr->grid_cells, (grid_cell_t){ 0 }, &mgr->allocator);
+        }
+        ++mgr->grid_cells[s->cell].count;
+    }
+
+    uint32_t first = 0;
+    for (grid_cell_t* cell = mgr->grid_cells; cell != tm_carray_end(mgr->grid_cells); ++cell) {
+        cell->first = first;
+        first += cell->count;
+        cell->count = 0;
+    }
+
+    for (uint32_t i = 0; i < n; ++i) {
+        grid_cell_t* cell = mgr->grid_cells + mgr->spatial[i].cell;
+        mgr->grid_entries[cell->first + cell->count++] = i;
+    }
+}
+
+// Finds the interactable that `is_player` can interact with, which is the closest to the ray from `origin`
+// along `forward`, within `radius` of `origin` and within the cone around `forward` given by `min_cos_angle`.
+// Only the grid cells overlapping the query sphere are visited. The distance from `origin` to the
+// interactable is returned in `distance`, so that callers can check for occlusion with a raycast.
+static tm_entity_t find_interactable(tm_interactable_component_manager_o* mgr, tm_vec3_t origin, tm_vec3_t forward, float radius, float min_cos_angle, bool is_player, float* distance)
+{
+    TM_PROFILER_BEGIN_FUNC_SCOPE();
+
+    tm_entity_t best = { 0 };
+    float best_miss = FLT_MAX;
+    float best_dist = 0;
+
+    const int32_t x0 = grid_coord(origin.x - radius), x1 = grid_coord(origin.x + radius);
+    const int32_t y0 = grid_coord(origin.y - radius), y1 = grid_coord(origin.y + radius);
+    const int32_t z0 = grid_coord(origin.z - radius), z1 = grid_coord(origin.z + radius);
+
+    for (int32_t x = x0; x <= x1; ++x) {
+        for (int32_t y = y0; y <= y1; ++y) {
+            for (int32_t z = z0; z <= z1; ++z) {
+                const uint32_t cell_idx = tm_hash_get_default(&mgr->grid_lookup, grid_cell_key(x, y, z), UINT32_MAX);
+                if (cell_idx == UINT32_MAX)
+                    continue;
+
+                const grid_cell_t* cell = mgr->grid_cells + cell_idx;
+                for (uint32_t i = cell->first; i < cell->first + cell->count; ++i) {
+                    const spatial_entry_t* s = mgr->spatial + mgr->grid_entries[i];
+                    const tm_vec3_t to = tm_vec3_sub(s->pos, origin);
+                    const float dist = tm_vec3_length(to);
+                    const float along = tm_vec3_dot(to, forward);
+
+                    if (dist > radius || along < min_cos_angle * dist)
+                        continue;
+
+                    // How far the view ray passes from the interactable.
+                    const float miss = tm_vec3_length(tm_vec3_sub(to, tm_vec3_mul(forward, along)));
+                    if (miss >= best_miss || !can_interact(mgr, s->entity, is_player))
+                        continue;
+
+                    best = s->entity;
+                    best_miss = miss;
+                    best_dist = dist;
+                }
+            }
+        }
+    }
+
+    if (distance)
+        *distance = best_dist;
+
+    TM_PROFILER_END_FUNC_SCOPE();
+    return best;
+}
+
+static tm_interactable_component_stats_t stats(const tm_interactable_component_manager_o* mgr)
+{
+    return (tm_interactable_component_stats_t){
+        .num_active = (uint32_t)tm_carray_size(mgr->active),
+        .num_queued = (uint32_t)tm_carray_size(mgr->activations[mgr->write_activations]),
+        .num_cached_chains = (uint32_t)tm_carray_size(mgr->chains),
+        .num_cached_chain_links = (uint32_t)tm_carray_size(mgr->chain_links),
+        .total_updates = mgr->total_updates,
+        .total_activations = mgr->total_activations,
+        .total_can_interact_calls = mgr->total_can_interact_calls,
+        .last_update_seconds = mgr->last_update_seconds,
+        .peak_active = mgr->peak_active,
+        .peak_queued = mgr->peak_queued,
+        .capacity = mgr->capacity,
+    };
+}
+
+static void set_clock(tm_interactable_component_manager_o* mgr, double t, float dt)
+{
+    mgr->use_clock = true;
+    mgr->clock_time = t;
+    mgr->clock_dt = dt;
+}
+
+static void clear_clock(tm_interactable_component_manager_o* mgr)
+{
+    mgr->use_clock = false;
 }
 
 static struct tm_interactable_component_api* tm_interactable_component_api = &(struct tm_interactable_component_api){
     .can_interact = can_interact,
     .interact = interact,
     .update_active_interactables = update_active_interactables,
+    .find_interactable = find_interactable,
+    .stats = stats,
+    .set_clock = set_clock,
+    .clear_clock = clear_clock,
 };
 
 // Special UI for editing the component in property editor
@@ -487,6 +1193,87 @@ static void component_loaded_from_gamestate(tm_component_manager_o* mgr_in, tm_e
 
 }
 
+// Reads everything `component__asset_loaded` needs from the interactable component of `entity_asset`.
+static void read_descriptor(tm_interactable_component_manager_o* mgr, tm_the_truth_o* tt, tm_tt_id_t entity_asset, interactable_descriptor_t* d)
+{
+    if (!mgr->interactable_tt_type.u64)
+        mgr->interactable_tt_type = tm_the_truth_api->object_type_from_name_hash(tt, TM_TT_TYPE_HASH__INTERACTABLE_COMPONENT);
+
+    const tm_tt_id_t asset = tm_the_truth_api->find_subobject_of_type(tt, tm_tt_read(tt, entity_asset), TM_TT_PROP__ENTITY__COMPONENTS, mgr->interactable_tt_type);
+    const tm_the_truth_object_o* asset_r = tm_tt_read(tt, asset);
+    const tm_tt_id_t target_id = tm_the_truth_api->get_reference(tt, asset_r, INTERACTABLE_COMPONENT_PROP__TARGET);
+    const tm_tt_id_t desc = tm_the_truth_api->get_subobject(tt, asset_r, INTERACTABLE_COMPONENT_PROP__DESC);
+
+    *d = (interactable_descriptor_t){
+        .entity_asset_version = tm_the_truth_api->version(tt, entity_asset),
+        .asset = asset,
+        .asset_version = tm_the_truth_api->version(tt, asset),
+        .desc = desc,
+        .desc_version = desc.u64 ? tm_the_truth_api->version(tt, desc) : 0,
+        .target = tm_the_truth_api->is_alive(tt, target_id) ? target_id : (tm_tt_id_t){ 0 },
+        .target_activation_delay = tm_the_truth_api->get_float(tt, asset_r, INTERACTABLE_COMPONENT_PROP__TARGET_ACTIVATION_DELAY),
+        .player_can_activate = tm_the_truth_api->get_bool(tt, asset_r, INTERACTABLE_COMPONENT_PROP__PLAYER_CAN_ACTIVATE),
+        .rotation = { 0, 0, 0, 1 },
+    };
+
+    if (!desc.u64)
+        return;
+
+    const tm_tt_type_t desc_type = tm_tt_type(desc);
+    const tm_the_truth_object_o* desc_r = tm_tt_read(tt, desc);
+    d->desc_type_hash = tm_the_truth_api->type_name_hash(tt, desc_type);
+
+    switch (TM_STRHASH_U64(d->desc_type_hash)) {
+    case TM_STRHASH_U64(TT_TYPE_HASH__INTERACTABLE_LEVER): {
+        const float handle_rotation_angle = tm_the_truth_api->get_float(tt, desc_r, INTERACTABLE_LEVER_PROP__HANDLE_ROTATE_ANGLE) * (TM_PI / 180.f);
+        const tm_vec3_t handle_rotation_axis = tm_vec3_normalize(tm_the_truth_common_types_api->get_vec3(tt, desc_r, INTERACTABLE_LEVER_PROP__HANDLE_ROTATE_AXIS));
+        d->animated = tm_the_truth_api->get_reference(tt, desc_r, INTERACTABLE_LEVER_PROP__HANDLE);
+        d->rotation = tm_quaternion_from_rotation(handle_rotation_axis, handle_rotation_angle);
+        d->time = tm_the_truth_api->get_float(tt, desc_r, INTERACTABLE_LEVER_PROP__HANDLE_OPEN_TIME);
+    } break;
+    case TM_STRHASH_U64(TT_TYPE_HASH__INTERACTABLE_BUTTON): {
+        const float button_push_distance = tm_the_truth_api->get_float(tt, desc_r, INTERACTABLE_BUTTON_PROP__BUTTON_PUSH_DISTANCE);
+        const tm_vec3_t button_push_axis = tm_vec3_normalize(tm_the_truth_common_types_api->get_vec3(tt, desc_r, INTERACTABLE_BUTTON_PROP__BUTTON_PUSH_AXIS));
+        d->animated = tm_the_truth_api->get_reference(tt, desc_r, INTERACTABLE_BUTTON_PROP__BUTTON);
+        d->offset = tm_vec3_mul(button_push_axis, button_push_distance);
+        d->time = tm_the_truth_api->get_float(tt, desc_r, INTERACTABLE_BUTTON_PROP__BUTTON_PUSH_TIME);
+    } break;
+    case TM_STRHASH_U64(TT_TYPE_HASH__INTERACTABLE_ROTATING_DOOR): {
+        const float pivot_rotate_angle = tm_the_truth_api->get_float(tt, desc_r, ROTATING_DOOR_PROP__PIVOT_ROTATE_ANGLE) * (TM_PI / 180.f);
+        const tm_vec3_t pivot_rotate_axis = tm_vec3_normalize(tm_the_truth_common_types_api->get_vec3(tt, desc_r, ROTATING_DOOR_PROP__PIVOT_ROTATE_AXIS));
+        d->animated = tm_the_truth_api->get_reference(tt, desc_r, ROTATING_DOOR_PROP__PIVOT);
+        d->rotation = tm_quaternion_from_rotation(pivot_rotate_axis, pivot_rotate_angle);
+        d->time = tm_the_truth_api->get_float(tt, desc_r, ROTATING_DOOR_PROP__PIVOT_ROTATE_TIME);
+    } break;
+    }
+
+    if (d->time < 0.001)
+        d->time = 1.0f;
+}
+
+// Returns the cached descriptor for `entity_asset`, (re-)reading it from The Truth if it isn't cached or if
+// any of the objects it was read from has changed since.
+static const interactable_descriptor_t* resolve_descriptor(tm_interactable_component_manager_o* mgr, tm_the_truth_o* tt, tm_tt_id_t entity_asset)
+{
+    uint32_t idx = tm_hash_get_default(&mgr->descriptor_lookup, entity_asset.u64, UINT32_MAX);
+
+    if (idx != UINT32_MAX) {
+        const interactable_descriptor_t* d = mgr->descriptors + idx;
+        if (d->entity_asset_version == tm_the_truth_api->version(tt, entity_asset)
+            && d->asset_version == tm_the_truth_api->version(tt, d->asset)
+            && (!d->desc.u64 || d->desc_version == tm_the_truth_api->version(tt, d->desc))) {
+            return d;
+        }
+    } else {
+        idx = (uint32_t)tm_carray_size(mgr->descriptors);
+        tm_carray_push(mgr->descriptors, (interactable_descriptor_t){ 0 }, &mgr->allocator);
+        tm_hash_add(&mgr->descriptor_lookup, entity_asset.u64, idx);
+    }
+
+    read_descriptor(mgr, tt, entity_asset, mgr->descriptors + idx);
+    return mgr->descriptors + idx;
+}
+
 // Loads stuff from The Truth into the structs that we get when we call tm_entity_api->get_component()
 static void component__asset_loaded(tm_component_manager_o* mgr_in,struct tm_entity_commands_o *commands, tm_entity_t e, void* data)
 {
@@ -495,66 +1282,46 @@ static void component__asset_loaded(tm_component_manager_o* mgr_in,struct tm_ent
     tm_entity_context_o* ctx = mgr->ctx;
     const tm_tt_id_t entity_asset = tm_entity_api->asset(mgr->ctx, e);
     tm_the_truth_o* tt = tm_entity_api->the_truth(mgr->ctx);
-    const tm_tt_type_t interactable_tt_type = tm_the_truth_api->object_type_from_name_hash(tt, TM_TT_TYPE_HASH__INTERACTABLE_COMPONENT);
-    const tm_tt_id_t asset = tm_the_truth_api->find_subobject_of_type(tt, tm_tt_read(tt, entity_asset), TM_TT_PROP__ENTITY__COMPONENTS, interactable_tt_type);
-    const tm_the_truth_object_o* asset_r = tm_tt_read(tt, asset);
-    const tm_tt_id_t target_id = tm_the_truth_api->get_reference(tt, asset_r, INTERACTABLE_COMPONENT_PROP__TARGET);
+    const interactable_descriptor_t* d = resolve_descriptor(mgr, tt, entity_asset);
 
-    if (tm_the_truth_api->is_alive(tt, target_id))
-        c->target = tm_entity_api->resolve_asset_reference(ctx, e, target_id);
+    // Any cached chain may lead to `e`, whether or not it has a target of its own.
+    c->target = d->target.u64 ? tm_entity_api->resolve_asset_reference(ctx, e, d->target) : (tm_entity_t){ 0 };
+    mgr->chains_dirty = true;
 
-    c->target_activation_delay = tm_the_truth_api->get_float(tt, asset_r, INTERACTABLE_COMPONENT_PROP__TARGET_ACTIVATION_DELAY);
-    c->player_can_activate = tm_the_truth_api->get_bool(tt, asset_r, INTERACTABLE_COMPONENT_PROP__PLAYER_CAN_ACTIVATE);
-
-    const tm_tt_id_t desc = tm_the_truth_api->get_subobject(tt, asset_r, INTERACTABLE_COMPONENT_PROP__DESC);
-    const tm_tt_type_t desc_type = tm_tt_type(desc);
-    const tm_strhash_t desc_type_hash = tm_the_truth_api->type_name_hash(tt, desc_type);
-    const tm_the_truth_object_o* desc_r = tm_tt_read(tt, desc);
+    c->target_activation_delay = d->target_activation_delay;
+    c->player_can_activate = d->player_can_activate;
+    c->type = INTERACTABLE_TYPE_NONE;
 
-    switch (TM_STRHASH_U64(desc_type_hash)) {
+    // The rest depends on the transform of the animated entity in this particular instance.
+    switch (TM_STRHASH_U64(d->desc_type_hash)) {
     case TM_STRHASH_U64(TT_TYPE_HASH__INTERACTABLE_LEVER): {
         c->type = INTERACTABLE_TYPE_LEVER;
         lever_t* l = &c->lever;
-        const tm_tt_id_t handle = tm_the_truth_api->get_reference(tt, desc_r, INTERACTABLE_LEVER_PROP__HANDLE);
-        const float handle_rotation_angle = tm_the_truth_api->get_float(tt, desc_r, INTERACTABLE_LEVER_PROP__HANDLE_ROTATE_ANGLE) * (TM_PI / 180.f);
-        const tm_vec3_t handle_rotation_axis = tm_vec3_normalize(tm_the_truth_common_types_api->get_vec3(tt, desc_r, INTERACTABLE_LEVER_PROP__HANDLE_ROTATE_AXIS));
-        if (handle.index) {
-            l->handle = tm_entity_api->resolve_asset_reference(ctx, e, handle);
+        if (d->animated.index) {
+            l->handle = tm_entity_api->resolve_asset_reference(ctx, e, d->animated);
             l->handle_closed_rotation = tm_get_local_rotation(mgr->trans_mgr, l->handle);
-            l->handle_open_rotation = tm_quaternion_mul(l->handle_closed_rotation, tm_quaternion_from_rotation(handle_rotation_axis, handle_rotation_angle));
-            l->handle_open_time = tm_the_truth_api->get_float(tt, desc_r, INTERACTABLE_LEVER_PROP__HANDLE_OPEN_TIME);
-            if (l->handle_open_time < 0.001)
-                l->handle_open_time = 1.0f;
+            l->handle_open_rotation = tm_quaternion_mul(l->handle_closed_rotation, d->rotation);
+            l->handle_open_time = d->time;
         }
     } break;
     case TM_STRHASH_U64(TT_TYPE_HASH__INTERACTABLE_BUTTON): {
         c->type = INTERACTABLE_TYPE_BUTTON;
         button_t* b = &c->button;
-        const tm_tt_id_t button = tm_the_truth_api->get_reference(tt, desc_r, INTERACTABLE_BUTTON_PROP__BUTTON);
-        const float button_push_distance = tm_the_truth_api->get_float(tt, desc_r, INTERACTABLE_BUTTON_PROP__BUTTON_PUSH_DISTANCE);
-        const tm_vec3_t button_push_axis = tm_vec3_normalize(tm_the_truth_common_types_api->get_vec3(tt, desc_r, INTERACTABLE_BUTTON_PROP__BUTTON_PUSH_AXIS));
-        if (button.index) {
-            b->button = tm_entity_api->resolve_asset_reference(ctx, e, button);
+        if (d->animated.index) {
+            b->button = tm_entity_api->resolve_asset_reference(ctx, e, d->animated);
             b->button_normal_position = tm_get_local_position(mgr->trans_mgr, b->button);
-            b->button_pushed_position = tm_vec3_add(b->button_normal_position, tm_vec3_mul(button_push_axis, button_push_distance));
-            b->button_push_time = tm_the_truth_api->get_float(tt, desc_r, INTERACTABLE_BUTTON_PROP__BUTTON_PUSH_TIME);
-            if (b->button_push_time < 0.001)
-                b->button_push_time = 1.0f;
+            b->button_pushed_position = tm_vec3_add(b->button_normal_position, d->offset);
+            b->button_push_time = d->time;
         }
     } break;
     case TM_STRHASH_U64(TT_TYPE_HASH__INTERACTABLE_ROTATING_DOOR): {
         c->type = INTERACTABLE_TYPE_ROTATING_DOOR;
         rotating_door_t* s = &c->rotating_door;
-        const tm_tt_id_t pivot = tm_the_truth_api->get_reference(tt, desc_r, ROTATING_DOOR_PROP__PIVOT);
-        const float pivot_rotate_angle = tm_the_truth_api->get_float(tt, desc_r, ROTATING_DOOR_PROP__PIVOT_ROTATE_ANGLE) * (TM_PI / 180.f);
-        const tm_vec3_t pivot_rotate_axis = tm_vec3_normalize(tm_the_truth_common_types_api->get_vec3(tt, desc_r, ROTATING_DOOR_PROP__PIVOT_ROTATE_AXIS));
-        if (pivot.index) {
-            s->pivot = tm_entity_api->resolve_asset_reference(ctx, e, pivot);
+        if (d->animated.index) {
+            s->pivot = tm_entity_api->resolve_asset_reference(ctx, e, d->animated);
             s->pivot_closed_rotation = tm_get_local_rotation(mgr->trans_mgr, s->pivot);
-            s->pivot_open_rotation = tm_quaternion_mul(s->pivot_closed_rotation, tm_quaternion_from_rotation(pivot_rotate_axis, pivot_rotate_angle));
-            s->pivot_rotate_time = tm_the_truth_api->get_float(tt, desc_r, ROTATING_DOOR_PROP__PIVOT_ROTATE_TIME);
-            if (s->pivot_rotate_time < 0.001)
-                s->pivot_rotate_time = 1.0f;
+            s->pivot_open_rotation = tm_quaternion_mul(s->pivot_closed_rotation, d->rotation);
+            s->pivot_rotate_time = d->time;
         }
     } break;
     }
@@ -576,61 +1343,131 @@ static void manager_components_created(tm_component_manager_o* man_in)
     manager_init(man);
 }
 
-static void tm_interactable_component__serialize(struct tm_simulation_gamestate_context_o* gs, tm_entity_t e, tm_component_type_t c, void* buffer, uint32_t buffer_size)
+// Returns the queued activation of `e`, or NULL if it isn't queued.
+static const activation_t* find_activation(const tm_interactable_component_manager_o* mgr, tm_entity_t e)
 {
-    interactable_component_t* dest = (interactable_component_t*)buffer;
-    const interactable_component_t* source = (interactable_component_t*)tm_entity_api->read_component(tm_simulation_gamestate_api->entity_ctx(gs), e, c);
-
-    *dest = *source;
+    const activation_t* activations = mgr->activations[mgr->write_activations];
+    for (const activation_t* act = activations; act != tm_carray_end(activations); ++act) {
+        if (act->interactable.u64 == e.u64)
+            return act;
+    }
+    return 0;
+}
 
-    tm_simulation_gamestate_api->entity_is_persistent(gs, source->target, 0, (tm_gamestate_object_id_t*)&dest->target, 0);
+// Drops the active interaction or queued activation of `e`, if it has one. The remaining active
+// interactions keep their order.
+static void cancel_interaction(tm_interactable_component_manager_o* mgr, tm_entity_t e)
+{
+    const uint32_t active_idx = tm_hash_get_default(&mgr->active_lookup, e.u64, UINT32_MAX);
+    if (active_idx == UINT32_MAX)
+        return;
+
+    tm_hash_remove(&mgr->active_lookup, e.u64);
+
+    if (active_idx == ACTIVATION_PENDING) {
+        activation_t* activations = mgr->activations[mgr->write_activations];
+        const uint32_t num_queued = (uint32_t)tm_carray_size(activations);
+        uint32_t num_kept = 0;
+        for (uint32_t i = 0; i < num_queued; ++i) {
+            if (activations[i].interactable.u64 != e.u64)
+                activations[num_kept++] = activations[i];
+        }
+        tm_carray_resize(mgr->activations[mgr->write_activations], num_kept, &mgr->allocator);
+        return;
+    }
 
-    switch (dest->type) {
-    case INTERACTABLE_TYPE_LEVER: {
-            tm_simulation_gamestate_api->entity_is_persistent(gs, source->lever.handle, 0, (tm_gamestate_object_id_t*)&dest->lever.handle, 0);
-    } break;
-    case INTERACTABLE_TYPE_BUTTON: {
-            tm_simulation_gamestate_api->entity_is_persistent(gs, source->button.button, 0, (tm_gamestate_object_id_t*)&dest->button.button, 0);
-    } break;
-    case INTERACTABLE_TYPE_ROTATING_DOOR: {
-            tm_simulation_gamestate_api->entity_is_persistent(gs, source->rotating_door.pivot, 0, (tm_gamestate_object_id_t*)&dest->rotating_door.pivot, 0);
-            tm_simulation_gamestate_api->entity_is_persistent(gs, source->rotating_door.target, 0, (tm_gamestate_object_id_t*)&dest->rotating_door.target, 0);
-    } break;
+    const uint32_t num_active = (uint32_t)tm_carray_size(mgr->active);
+    for (uint32_t i = active_idx + 1; i < num_active; ++i) {
+        mgr->active[i - 1] = mgr->active[i];
+        move_track(&mgr->tracks, i, i - 1);
+        tm_hash_add(&mgr->active_lookup, mgr->active[i - 1].interactable.u64, i - 1);
     }
+    tm_carray_resize(mgr->active, num_active - 1, &mgr->allocator);
+    shrink_tracks(&mgr->tracks, num_active - 1);
 }
 
-static void tm_interactable_component__deserialize(struct tm_simulation_gamestate_context_o* gs, tm_entity_t e, tm_component_type_t c, const void* buffer, uint32_t buffer_size)
+static void tm_interactable_component__serialize(struct tm_simulation_gamestate_context_o* gs, tm_entity_t e, tm_component_type_t c, void* buffer, uint32_t buffer_size)
 {
-    interactable_component_t* dest = (interactable_component_t*)tm_entity_api->write_component(tm_simulation_gamestate_api->entity_ctx(gs), e, c);
-    interactable_component_t* source = (interactable_component_t*)buffer;
+    tm_entity_context_o* ctx = tm_simulation_gamestate_api->entity_ctx(gs);
+    const tm_interactable_component_manager_o* mgr = (tm_interactable_component_manager_o*)tm_entity_api->component_manager(ctx, c);
+    const interactable_component_t* source = (interactable_component_t*)tm_entity_api->read_component(ctx, e, c);
+    interactable_gamestate_t* dest = (interactable_gamestate_t*)buffer;
 
-    *dest = *source;
+    *dest = (interactable_gamestate_t){ .state = (uint8_t)get_state(source) };
 
-    dest->target = tm_simulation_gamestate_api->lookup_entity_from_gamestate_id(gs, (tm_gamestate_object_id_t*)&source->target);
+    // Most interactables are at rest when a snapshot is taken, there's nothing more to record for them.
+    if (!tm_carray_size(mgr->active) && !tm_carray_size(mgr->activations[mgr->write_activations]))
+        return;
 
-    switch (dest->type) {
-    case INTERACTABLE_TYPE_LEVER: {
-            dest->lever.handle = tm_simulation_gamestate_api->lookup_entity_from_gamestate_id(gs, (tm_gamestate_object_id_t*)&source->lever.handle);
-    } break;
-    case INTERACTABLE_TYPE_BUTTON: {
-            dest->button.button = tm_simulation_gamestate_api->lookup_entity_from_gamestate_id(gs, (tm_gamestate_object_id_t*)&source->button.button);
-    } break;
-    case INTERACTABLE_TYPE_ROTATING_DOOR: {
-            dest->rotating_door.pivot = tm_simulation_gamestate_api->lookup_entity_from_gamestate_id(gs, (tm_gamestate_object_id_t*)&source->rotating_door.pivot);
-            source->rotating_door.target = tm_simulation_gamestate_api->lookup_entity_from_gamestate_id(gs, (tm_gamestate_object_id_t*)&source->rotating_door.target);
-    } break;
+    const uint32_t active_idx = tm_hash_get_default(&mgr->active_lookup, e.u64, UINT32_MAX);
+
+    if (active_idx == ACTIVATION_PENDING) {
+        const activation_t* act = find_activation(mgr, e);
+        if (act) {
+            dest->active = true;
+            dest->start_time = act->time;
+            dest->target_activated = act->target_activated;
+        }
+    } else if (active_idx != UINT32_MAX) {
+        dest->active = true;
+        dest->start_time = mgr->active[active_idx].start_time;
+        dest->target_activated = mgr->active[active_idx].target_activated;
+    }
+}
+
+static void tm_interactable_component__deserialize(struct tm_simulation_gamestate_context_o* gs, tm_entity_t e, tm_component_type_t c, const void* buffer, uint32_t buffer_size)
+{
+    tm_entity_context_o* ctx = tm_simulation_gamestate_api->entity_ctx(gs);
+    tm_interactable_component_manager_o* mgr = (tm_interactable_component_manager_o*)tm_entity_api->component_manager(ctx, c);
+    interactable_component_t* dest = (interactable_component_t*)tm_entity_api->write_component(ctx, e, c);
+    const interactable_gamestate_t* source = (const interactable_gamestate_t*)buffer;
+
+    // Whatever `e` was doing before the restore is replaced by what it was doing in the snapshot.
+    cancel_interaction(mgr, e);
+
+    // The targets of the restored entities may not be the ones the chains were cached for.
+    mgr->chains_dirty = true;
+
+    // The state is only meaningful for the type set up by `component__asset_loaded`. Without it, there's
+    // nothing to restore.
+    if (!dest || dest->type == INTERACTABLE_TYPE_NONE)
+        return;
+
+    set_state(dest, source->state);
+
+    // Interactions that were in flight are queued again with their original start time, the update sets
+    // up their tracks from the restored state.
+    if (source->active) {
+        tm_hash_add(&mgr->active_lookup, e.u64, ACTIVATION_PENDING);
+        tm_carray_push(mgr->activations[mgr->write_activations], ((activation_t){ .time = source->start_time, .interactable = e, .target_activated = source->target_activated }), &mgr->allocator);
+        mgr->peak_queued = tm_max(mgr->peak_queued, (uint32_t)tm_carray_size(mgr->activations[mgr->write_activations]));
     }
 }
 
 static tm_component_gamestate_representation_i* interactable_component_gamestate_representation = &(tm_component_gamestate_representation_i){
     .loaded = component_loaded_from_gamestate,
-    .size = sizeof(interactable_component_t),
+    .size = sizeof(interactable_gamestate_t),
     .serialize = tm_interactable_component__serialize,
     .deserialize = tm_interactable_component__deserialize,
 };
 
 static tm_component_persistence_i* interactable_component_persistence = &(tm_component_persistence_i){ 0 };
 
+// A cached chain that is blocked by `e` or runs through it changes when `e` gains or loses its
+// interactable component.
+static void component__add(tm_component_manager_o* mgr_in, struct tm_entity_commands_o* commands, tm_entity_t e, void* data)
+{
+    tm_interactable_component_manager_o* mgr = (tm_interactable_component_manager_o*)mgr_in;
+    mgr->chains_dirty = true;
+}
+
+static void component__remove(tm_component_manager_o* mgr_in, struct tm_entity_commands_o* commands, tm_entity_t e, void* data)
+{
+    tm_interactable_component_manager_o* mgr = (tm_interactable_component_manager_o*)mgr_in;
+    cancel_interaction(mgr, e);
+    mgr->chains_dirty = true;
+}
+
 static void component__create(struct tm_entity_context_o* ctx)
 {
     tm_allocator_i a;
@@ -641,6 +1478,8 @@ static void component__create(struct tm_entity_context_o* ctx)
         .name = TM_TT_TYPE__INTERACTABLE_COMPONENT,
         .bytes = sizeof(struct interactable_component_t),
         .asset_loaded = component__asset_loaded,
+        .add = component__add,
+        .remove = component__remove,
         .destroy = component__destroy,
         .manager = (tm_component_manager_o*)m,
         .components_created = manager_components_created,
@@ -653,6 +1492,96 @@ static void component__create(struct tm_entity_context_o* ctx)
         .ctx = ctx,
         .interactable_component_type = interactable_component_type,
     };
+
+    m->active_lookup.allocator = &m->allocator;
+    m->chain_lookup.allocator = &m->allocator;
+    m->descriptor_lookup.allocator = &m->allocator;
+    m->grid_lookup.allocator = &m->allocator;
+}
+
+// Copies the world positions of all interactables in `data` into the spatial index, if their transform has
+// changed since last time, and rebuilds the grid if anything changed.
+static void refresh_spatial_index(tm_interactable_component_manager_o* mgr, const tm_engine_update_set_t* data)
+{
+    uint32_t num_interactables = 0;
+    for (const tm_engine_update_array_t* a = data->arrays; a < data->arrays + data->num_arrays; ++a)
+        num_interactables += a->n;
+
+    reserve_capacity(mgr, num_interactables);
+
+    bool dirty = num_interactables != tm_carray_size(mgr->spatial);
+    tm_carray_resize(mgr->spatial, num_interactables, &mgr->allocator);
+
+    uint32_t n = 0;
+    for (const tm_engine_update_array_t* a = data->arrays; a < data->arrays + data->num_arrays; ++a) {
+        const tm_transform_component_t* transforms = (const tm_transform_component_t*)a->components[1];
+        for (uint32_t i = 0; i < a->n; ++i, ++n) {
+            spatial_entry_t* s = mgr->spatial + n;
+            if (s->entity.u64 == a->entities[i].u64 && s->version == transforms[i].version)
+                continue;
+
+            s->entity = a->entities[i];
+            s->pos = transforms[i].world.pos;
+            s->version = transforms[i].version;
+            dirty = true;
+        }
+    }
+
+    if (dirty)
+        rebuild_grid(mgr);
+}
+
+enum interactable_bb {
+    INTERACTABLE_BB__DELTA_TIME,
+    INTERACTABLE_BB__TIME,
+    INTERACTABLE_BB__COUNT,
+};
+
+// Runs on (interactable_component, transform_component). The update arrays are used to keep the spatial
+// index up to date, the active interactions are kept by the manager. Listing the components also lets the
+// scheduler know what this engine touches and run it on a worker thread alongside engines that don't.
+static void engine_update__interactables(tm_engine_o* inst, tm_engine_update_set_t* data, struct tm_entity_commands_o* commands)
+{
+    tm_interactable_component_manager_o* mgr = (tm_interactable_component_manager_o*)inst;
+
+    refresh_spatial_index(mgr, data);
+
+    const float dt = mgr->use_clock ? mgr->clock_dt : (float)blackboard_cache_double(&mgr->blackboard, data, INTERACTABLE_BB__DELTA_TIME, 0);
+    const double t = mgr->use_clock ? mgr->clock_time : blackboard_cache_double(&mgr->blackboard, data, INTERACTABLE_BB__TIME, 0);
+
+    update_active_interactables(mgr, dt, t);
+}
+
+static bool engine_filter__interactables(tm_engine_o* inst, const tm_component_type_t* components, uint32_t num_components, const tm_component_mask_t* mask)
+{
+    return tm_entity_mask_has_component(mask, components[0]) && tm_entity_mask_has_component(mask, components[1]);
+}
+
+static void component__register_engine(struct tm_entity_context_o* ctx)
+{
+    const tm_component_type_t interactable_component = tm_entity_api->lookup_component_type(ctx, TM_TT_TYPE_HASH__INTERACTABLE_COMPONENT);
+    const tm_component_type_t transform_component = tm_entity_api->lookup_component_type(ctx, TM_TT_TYPE_HASH__TRANSFORM_COMPONENT);
+    tm_interactable_component_manager_o* mgr = (tm_interactable_component_manager_o*)tm_entity_api->component_manager(ctx, interactable_component);
+
+    const tm_strhash_t blackboard_keys[INTERACTABLE_BB__COUNT] = {
+        [INTERACTABLE_BB__DELTA_TIME] = TM_ENTITY_BB__DELTA_TIME,
+        [INTERACTABLE_BB__TIME] = TM_ENTITY_BB__TIME,
+    };
+    blackboard_cache_init(&mgr->blackboard, blackboard_keys, INTERACTABLE_BB__COUNT);
+
+    // The engine writes the transforms of lever handles, buttons and door pivots, and the state of the
+    // interactables themselves.
+    const tm_engine_i interactable_engine = {
+        .ui_name = "Interactable Component",
+        .hash = TM_STATIC_HASH("TM_ENGINE__INTERACTABLE_COMPONENT", 0x7ed51d3b8626abdaULL),
+        .num_components = 2,
+        .components = { interactable_component, transform_component },
+        .writes = { true, true },
+        .update = engine_update__interactables,
+        .filter = engine_filter__interactables,
+        .inst = (tm_engine_o*)mgr,
+    };
+    tm_entity_api->register_engine(ctx, &interactable_engine);
 }
 
 static void gamestate_component__create(struct tm_simulation_gamestate_context_o* gs)
@@ -757,9 +1686,12 @@ void load_interactable_component(struct tm_api_registry_api* reg, bool load)
     tm_transform_component_api = tm_get_api(reg, tm_transform_component_api);
     tm_the_truth_common_types_api = tm_get_api(reg, tm_the_truth_common_types_api);
     tm_simulation_gamestate_api = tm_get_api(reg, tm_simulation_gamestate_api);
+    tm_profiler_api = tm_get_api(reg, tm_profiler_api);
+    tm_os_api = tm_get_api(reg, tm_os_api);
 
     tm_set_or_remove_api(reg, load, tm_interactable_component_api, tm_interactable_component_api);
     tm_add_or_remove_implementation(reg, load, tm_the_truth_create_types_i, create_truth_types);
     tm_add_or_remove_implementation(reg, load, tm_entity_create_component_i, component__create);
+    tm_add_or_remove_implementation(reg, load, tm_entity_register_engines_simulation_i, component__register_engine);
     tm_add_or_remove_implementation(reg, load, tm_simulation_create_gamestate_component_i, gamestate_component__create);
 }
@@ -5,12 +5,65 @@
 
 typedef struct tm_interactable_component_manager_o tm_interactable_component_manager_o;
 
+// Counters and sizes reported by `tm_interactable_component_api->stats()`. The counters accumulate from when
+// the component manager was created.
+typedef struct tm_interactable_component_stats_t {
+    // Number of interactions currently animating or waiting for their target.
+    uint32_t num_active;
+
+    // Number of activations queued for the next update.
+    uint32_t num_queued;
+
+    // Number of cached target chains and the total number of links in them.
+    uint32_t num_cached_chains;
+    uint32_t num_cached_chain_links;
+
+    uint64_t total_updates;
+    uint64_t total_activations;
+    uint64_t total_can_interact_calls;
+
+    // Wall-clock time spent in the most recent `update_active_interactables()` call.
+    double last_update_seconds;
+
+    // Largest number of active interactions and queued activations seen so far.
+    uint32_t peak_active;
+    uint32_t peak_queued;
+
+    // Number of interactables the manager has reserved room for. Activations don't allocate as long as the
+    // peaks stay within this.
+    uint32_t capacity;
+    TM_PAD(4);
+} tm_interactable_component_stats_t;
+
 #define TM_INTERACTABLE_COMPONENT_API_NAME "tm_interactable_component_api"
 
 struct tm_interactable_component_api {
     bool (*can_interact)(tm_interactable_component_manager_o* mgr, tm_entity_t interactable, bool is_player);
     void (*interact)(tm_interactable_component_manager_o* mgr, tm_entity_t interactable);
+
+    // Called by the interactable engine every simulation frame, so gameplay code doesn't need to call it.
     void (*update_active_interactables)(tm_interactable_component_manager_o* mgr, float dt, double t);
+
+    // Returns the interactable that the player (if `is_player` is set) can interact with that is closest to
+    // the ray from `origin` along the normalized `forward`, within `radius` of `origin` and within the cone
+    // around `forward` given by `min_cos_angle`. The interactables are looked up in a spatial index, no
+    // physics queries are made, so callers that care about occlusion should confirm the result with a
+    // raycast. The distance to the returned interactable is written to `distance`, if non-NULL.
+    tm_entity_t (*find_interactable)(tm_interactable_component_manager_o* mgr, tm_vec3_t origin, tm_vec3_t forward, float radius, float min_cos_angle, bool is_player, float* distance);
+
+    // Returns counters and sizes of the manager, for profiling and debug overlays.
+    tm_interactable_component_stats_t (*stats)(const tm_interactable_component_manager_o* mgr);
+
+    // Makes the interactable engine update with time `t` and delta time `dt` instead of the time on the
+    // entity blackboard, from its next update on. The values stick until the next call or until
+    // `clear_clock()`, so gameplay code that drives its own clock, such as an input replay, should call this
+    // every frame. Activations are timestamped with the time of the most recent update, so they follow this
+    // clock too.
+    void (*set_clock)(tm_interactable_component_manager_o* mgr, double t, float dt);
+
+    // Makes the interactable engine go back to the time on the entity blackboard, from its next update on,
+    // after `set_clock()`.
+    void (*clear_clock)(tm_interactable_component_manager_o* mgr);
 };
 
-#define tm_interactable_component_api_version TM_VERSION(1, 0, 0)
+#define tm_interactable_component_api_version TM_VERSION(1, 4, 0)
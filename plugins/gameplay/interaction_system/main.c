@@ -21,6 +21,9 @@ static struct tm_ui_api *tm_ui_api;
 static struct tm_interactable_component_api *tm_interactable_component_api;
 static struct tm_gamestate_api *tm_gamestate_api;
 static struct tm_simulation_gamestate_api* tm_simulation_gamestate_api;
+static struct tm_logger_api *tm_logger_api;
+static struct tm_os_api *tm_os_api;
+static struct tm_profiler_api *tm_profiler_api;
 
 #include "interactable_component.h"
 
@@ -29,7 +32,10 @@ static struct tm_simulation_gamestate_api* tm_simulation_gamestate_api;
 #include <foundation/application.h>
 #include <foundation/error.h>
 #include <foundation/input.h>
+#include <foundation/log.h>
 #include <foundation/murmurhash64a.inl>
+#include <foundation/os.h>
+#include <foundation/profiler.h>
 #include <foundation/temp_allocator.h>
 #include <foundation/the_truth.h>
 
@@ -49,18 +55,23 @@ static struct tm_simulation_gamestate_api* tm_simulation_gamestate_api;
 #include <foundation/carray.inl>
 #include <foundation/math.inl>
 
-typedef struct input_state_t
-{
-    bool held_keys[TM_INPUT_KEYBOARD_ITEM_COUNT];
-    bool left_mouse_held;
-    bool left_mouse_pressed;
-    TM_PAD(1);
-    tm_vec2_t mouse_delta;
-} input_state_t;
+#include "../shared/input_state.inl"
+#include "../shared/input_recorder.inl"
+#include "../shared/raycast_batch.inl"
+
+// Where the Record and Replay simulation entries write and read the input recording.
+#define INPUT_RECORDING_PATH "gameplay_interaction_system.input"
 
 struct tm_simulation_state_o
 {
     input_state_t input;
+
+    // Records or replays the input, see the Record and Replay simulation entries.
+    input_recorder_t recorder;
+
+    // Raycasts of this frame.
+    raycast_batch_t rays;
+
     tm_entity_t player;
     tm_entity_t player_camera;
 
@@ -75,7 +86,6 @@ struct tm_simulation_state_o
 
     double last_standing_time;
 
-    uint64_t processed_events;
     tm_entity_context_o *entity_ctx;
     tm_the_truth_o *tt;
     tm_simulation_o *sim;
@@ -132,7 +142,7 @@ static void deserialize(void *d, void *s)
     tm_simulation_api->set_camera(dest->sim, dest->player_camera);
 }
 
-static tm_simulation_state_o *start(tm_simulation_start_args_t *args)
+static tm_simulation_state_o *start_with_recorder(tm_simulation_start_args_t *args, enum input_recorder_mode mode)
 {
     tm_simulation_state_o *state = tm_alloc(args->allocator, sizeof(*state));
     *state = (tm_simulation_state_o){
@@ -142,6 +152,9 @@ static tm_simulation_state_o *start(tm_simulation_start_args_t *args)
         .tt = args->tt,
     };
 
+    input_recorder_init(&state->recorder, state->allocator, mode, INPUT_RECORDING_PATH, 0);
+    raycast_batch_init(&state->rays, state->allocator);
+
     state->interact_comp = tm_entity_api->lookup_component_type(state->entity_ctx, TM_TT_TYPE_HASH__INTERACTABLE_COMPONENT);
     state->tag_comp = tm_entity_api->lookup_component_type(state->entity_ctx, TM_TT_TYPE_HASH__TAG_COMPONENT);
     state->transform_comp = tm_entity_api->lookup_component_type(state->entity_ctx, TM_TT_TYPE_HASH__TRANSFORM_COMPONENT);
@@ -182,78 +195,41 @@ static tm_simulation_state_o *start(tm_simulation_start_args_t *args)
     return state;
 }
 
+static tm_simulation_state_o *start(tm_simulation_start_args_t *args)
+{
+    return start_with_recorder(args, INPUT_RECORDER_MODE_OFF);
+}
+
+// Logs the cost per tick of a replay and the raycasts it made.
+static void log_replay_stats(tm_simulation_state_o *state)
+{
+    input_recorder_log_replay_stats(&state->recorder);
+    raycast_batch_log_stats(&state->rays, state->recorder.num_frames);
+}
+
 static void stop(tm_simulation_state_o *state, struct tm_entity_commands_o *commands)
 {
     tm_allocator_i a = *state->allocator;
+    // A replay that reached the end of the log has already logged its cost, see `tick_replay()`.
+    if (state->recorder.mode == INPUT_RECORDER_MODE_REPLAY)
+        log_replay_stats(state);
+    input_recorder_shutdown(&state->recorder);
+    raycast_batch_free(&state->rays);
     tm_free(&a, state, sizeof(*state));
 }
 
 static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
 {
-    // Reset per-frame-input
-    state->input.mouse_delta.x = state->input.mouse_delta.y = 0;
-    state->input.left_mouse_pressed = false;
-
-    // Read input
-    tm_input_event_t events[32];
-    bool mouse_captured_this_frame = state->mouse_captured;
-    while (true)
-    {
-        uint64_t n = tm_input_api->events(state->processed_events, events, 32);
-
-        for (uint64_t i = 0; i < n; ++i)
-        {
-            const tm_input_event_t *e = events + i;
-            if (mouse_captured_this_frame)
-            {
-                if (e->source && e->source->controller_type == TM_INPUT_CONTROLLER_TYPE_MOUSE)
-                {
-                    if (e->item_id == TM_INPUT_MOUSE_ITEM_BUTTON_LEFT)
-                    {
-                        const bool down = e->data.f.x > 0.5f;
-                        state->input.left_mouse_pressed = down && !state->input.left_mouse_held;
-                        state->input.left_mouse_held = down;
-                    }
-                    else if (e->item_id == TM_INPUT_MOUSE_ITEM_MOVE)
-                    {
-                        state->input.mouse_delta.x += e->data.f.x;
-                        state->input.mouse_delta.y += e->data.f.y;
-                    }
-                }
-                if (e->source && e->source->controller_type == TM_INPUT_CONTROLLER_TYPE_KEYBOARD)
-                {
-                    if (e->type == TM_INPUT_EVENT_TYPE_DATA_CHANGE)
-                    {
-                        state->input.held_keys[e->item_id] = e->data.f.x == 1.0f;
-                    }
-                }
-            }
-            else
-            {
-                if (e->source && e->source->controller_type == TM_INPUT_CONTROLLER_TYPE_MOUSE)
-                {
-                    if (e->item_id == TM_INPUT_MOUSE_ITEM_BUTTON_LEFT)
-                    {
-                        const bool down = e->data.f.x > 0.5f;
-                        state->input.left_mouse_pressed = down && !state->input.left_mouse_held;
-                        state->input.left_mouse_held = down;
-                    }
-                }
-
-                if (e->source && e->source->controller_type == TM_INPUT_CONTROLLER_TYPE_KEYBOARD)
-                {
-                    if (e->item_id == TM_INPUT_KEYBOARD_ITEM_ESCAPE && e->type == TM_INPUT_EVENT_TYPE_DATA_CHANGE)
-                    {
-                        state->input.held_keys[e->item_id] = e->data.f.x == 1.0f;
-                    }
-                }
-            }
-        }
+    // Read input. When replaying, this also replaces the time and delta time with the recorded ones.
+    if (!input_recorder_update(&state->recorder, &state->input, &state->mouse_captured, &args->time, &args->dt))
+        return;
 
-        state->processed_events += n;
-        if (n < 32)
-            break;
-    }
+    // When recording or replaying, the interactable engine runs on the recorded clock rather than the blackboard
+    // time, so interactions start and animate at the same times in the replay as in the recording. The engine
+    // may run before this tick in a frame, in which case it uses the time of the previous tick. It does so both
+    // when recording and replaying, so the two still match.
+    if (state->recorder.mode != INPUT_RECORDER_MODE_OFF)
+        tm_interactable_component_api->set_clock(state->interactable_mgr, args->time, args->dt);
 
     // Capture mouse
     if (args->ui)
@@ -263,7 +239,7 @@ static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
             state->mouse_captured = true;
         }
 
-        if ((args->running_in_editor && state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_ESCAPE]) || !tm_ui_api->window_has_focus(args->ui))
+        if ((args->running_in_editor && input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_ESCAPE)) || !tm_ui_api->window_has_focus(args->ui))
         {
             state->mouse_captured = false;
             struct tm_application_o *app = tm_application_api->application();
@@ -277,9 +253,6 @@ static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
         }
     }
 
-    // Updates any inteactables that are moving etc.
-    tm_interactable_component_api->update_active_interactables(state->interactable_mgr, args->dt, args->time);
-
     const tm_vec3_t camera_pos = tm_get_position(state->trans_mgr, state->player_camera);
     const tm_vec4_t camera_rot = tm_get_rotation(state->trans_mgr, state->player_camera);
     struct tm_physics_mover_component_t *player_mover = tm_entity_api->write_component_by_hash(state->entity_ctx, state->player, TM_TT_TYPE_HASH__PHYSICS_MOVER_COMPONENT);
@@ -294,17 +267,17 @@ static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
     if (state->mouse_captured)
     {
         // Exit on ESC
-        if (!args->running_in_editor && state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_ESCAPE])
+        if (!args->running_in_editor && input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_ESCAPE))
             tm_application_api->exit(tm_application_api->application(), false);
 
         tm_vec3_t local_movement = {0};
-        if (state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_A])
+        if (input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_A))
             local_movement.x -= 1.0f;
-        if (state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_D])
+        if (input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_D))
             local_movement.x += 1.0f;
-        if (state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_W])
+        if (input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_W))
             local_movement.z -= 1.0f;
-        if (state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_S])
+        if (input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_S))
             local_movement.z += 1.0f;
 
         // Move
@@ -335,30 +308,46 @@ static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
 
         // Jump
         const bool can_jump = args->time < state->last_standing_time + 0.2f;
-        if (can_jump && state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_SPACE])
+        if (can_jump && input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_SPACE))
         {
             player_mover->velocity.y = 3.5;
             state->last_standing_time = 0;
         }
     }
 
-    // Modified if the raycast below hits something that can be interacted with.
+    // Modified if the query below finds something that can be interacted with.
     tm_color_srgb_t crosshair_color = {70, 80, 70, 255};
 
+    // Look for the interactable closest to the crosshair in the spatial index of the interactable manager,
+    // then confirm with a single raycast towards it that nothing is in the way. This finds thin levers that a
+    // raycast along the view direction would miss, and skips the raycast when nothing interactable is near.
     const tm_vec3_t camera_forward = tm_quaternion_rotate_vec3(camera_rot, (tm_vec3_t){0, 0, -1});
-    const tm_physx_raycast_t r = tm_physx_scene_api->raycast(args->physx_scene, camera_pos, camera_forward, 2.5f, state->player_collision_type, (tm_physx_raycast_flags_t){0}, 0, 0);
+    float interactable_dist;
+    const tm_entity_t interactable = tm_interactable_component_api->find_interactable(state->interactable_mgr, camera_pos, camera_forward, 2.5f, 0.95f, true, &interactable_dist);
 
-    if (r.has_block)
+    raycast_batch_reset(&state->rays);
+    uint32_t occlusion_ray = UINT32_MAX;
+    if (interactable.u64)
     {
-        const tm_entity_t hit = r.block.body;
-        const tm_component_mask_t *hit_mask = tm_entity_api->component_mask(state->entity_ctx, hit);
-        if (tm_entity_mask_has_component(hit_mask, state->interact_comp) && tm_interactable_component_api->can_interact(state->interactable_mgr, hit, true))
+        const tm_vec3_t to_interactable = tm_vec3_sub(tm_get_position(state->trans_mgr, interactable), camera_pos);
+        const tm_vec3_t dir = interactable_dist > 0.001f ? tm_vec3_mul(to_interactable, 1.0f / interactable_dist) : camera_forward;
+        occlusion_ray = raycast_batch_add(&state->rays, camera_pos, dir, interactable_dist, state->player_collision_type);
+    }
+    raycast_batch_execute(&state->rays, args->physx_scene);
+
+    if (interactable.u64)
+    {
+        const tm_physx_raycast_t *r = raycast_batch_result(&state->rays, occlusion_ray);
+
+        // The interactable's own collider, or anything just around its origin, doesn't count as occluding.
+        const bool occluded = r->has_block && r->block.body.u64 != interactable.u64 && r->block.distance < interactable_dist - 0.1f;
+        if (!occluded)
         {
             crosshair_color = (tm_color_srgb_t){255, 255, 255, 255};
             if (state->input.left_mouse_pressed)
             {
                 // This is what starts the interaction!
-                tm_interactable_component_api->interact(state->interactable_mgr, hit);
+                tm_interactable_component_api->interact(state->interactable_mgr, interactable);
             }
         }
     }
@@ -383,6 +372,68 @@ static tm_simulation_entry_i simulation_entry_i = {
     .tick = tick,
 };
 
+static tm_simulation_state_o *start_record(tm_simulation_start_args_t *args)
+{
+    return start_with_recorder(args, INPUT_RECORDER_MODE_RECORD);
+}
+
+static tm_simulation_state_o *start_replay(tm_simulation_start_args_t *args)
+{
+    return start_with_recorder(args, INPUT_RECORDER_MODE_REPLAY);
+}
+
+// Ticks the simulation with the recorded input, without UI, and measures the cost of the gameplay code.
+// Plays `INPUT_RECORDER_REPLAY_FRAMES_PER_TICK` recorded frames per call. When the log runs out, it logs the
+// cost and stops ticking the simulation.
+static void tick_replay(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
+{
+    if (state->recorder.mode == INPUT_RECORDER_MODE_REPLAY_DONE)
+        return;
+
+    for (uint32_t i = 0; i < INPUT_RECORDER_REPLAY_FRAMES_PER_TICK; ++i)
+    {
+        tm_simulation_frame_args_t replay_args = *args;
+        replay_args.ui = 0;
+
+        const tm_clock_o start_time = tm_os_api->time->now();
+        tick(state, &replay_args);
+        const double seconds = tm_os_api->time->delta(tm_os_api->time->now(), start_time);
+
+        if (state->recorder.mode == INPUT_RECORDER_MODE_REPLAY_DONE)
+        {
+            log_replay_stats(state);
+            tm_interactable_component_api->clear_clock(state->interactable_mgr);
+            return;
+        }
+        state->recorder.replay_tick_seconds += seconds;
+
+        // If the log couldn't be loaded, the simulation plays on live input, one frame per tick.
+        if (state->recorder.mode != INPUT_RECORDER_MODE_REPLAY)
+            return;
+    }
+}
+
+// Plays like the regular entry, but records the input to `INPUT_RECORDING_PATH` when stopped.
+static tm_simulation_entry_i record_simulation_entry_i = {
+    .id = TM_STATIC_HASH("Gameplay Interaction System (Record Input)", 0x220177cd5b67392dULL),
+    .display_name = "Gameplay Interaction System (Record Input)",
+    .start = start_record,
+    .stop = stop,
+    .tick = tick,
+};
+
+// Replays `INPUT_RECORDING_PATH` and logs the cost per tick at the end of the log, or when stopped before
+// that. The interactable engine runs on the recorded time too, see `tick()`, but PhysX steps with the live
+// frame time, so the replay is not deterministic: the player can end up in a different place than in the
+// recording, and raycasts can hit different things.
+static tm_simulation_entry_i replay_simulation_entry_i = {
+    .id = TM_STATIC_HASH("Gameplay Interaction System (Replay Input)", 0xf2c63f5b7f562a2fULL),
+    .display_name = "Gameplay Interaction System (Replay Input)",
+    .start = start_replay,
+    .stop = stop,
+    .tick = tick_replay,
+};
+
 extern void load_interactable_component(struct tm_api_registry_api *reg, bool load);
 
 TM_DLL_EXPORT void tm_load_plugin(struct tm_api_registry_api *reg, bool load)
@@ -403,7 +454,12 @@ TM_DLL_EXPORT void tm_load_plugin(struct tm_api_registry_api *reg, bool load)
     tm_interactable_component_api = tm_get_api(reg, tm_interactable_component_api);
     tm_gamestate_api = tm_get_api(reg, tm_gamestate_api);
     tm_simulation_gamestate_api = tm_get_api(reg, tm_simulation_gamestate_api);
+    tm_logger_api = tm_get_api(reg, tm_logger_api);
+    tm_os_api = tm_get_api(reg, tm_os_api);
+    tm_profiler_api = tm_get_api(reg, tm_profiler_api);
 
     tm_add_or_remove_implementation(reg, load, tm_simulation_entry_i, &simulation_entry_i);
+    tm_add_or_remove_implementation(reg, load, tm_simulation_entry_i, &record_simulation_entry_i);
+    tm_add_or_remove_implementation(reg, load, tm_simulation_entry_i, &replay_simulation_entry_i);
     load_interactable_component(reg, load);
 }
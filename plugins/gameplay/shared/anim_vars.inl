@@ -0,0 +1,68 @@
+// Sets the variables of animation state machines that are driven by gameplay code, such as the movement
+// keys of a character, while skipping the variables that haven't changed since they were last set. The
+// variable names are hashed at compile time, so an `enum anim_var` value serves as the handle of a variable.
+//
+// The including file must declare
+// `static struct tm_animation_state_machine_api *tm_animation_state_machine_api;` and include
+// `plugins/animation/animation_state_machine.h` before including this file.
+
+// Animation state machine variables driven by input.
+enum anim_var
+{
+    ANIM_VAR_W,
+    ANIM_VAR_A,
+    ANIM_VAR_S,
+    ANIM_VAR_D,
+    ANIM_VAR_RUN,
+    ANIM_VAR_COUNT,
+};
+
+static const tm_strhash_t anim_var_names[ANIM_VAR_COUNT] = {
+    [ANIM_VAR_W] = TM_STATIC_HASH("w", 0x22727cb14c3bb41dULL),
+    [ANIM_VAR_A] = TM_STATIC_HASH("a", 0x71717d2d36b6b11ULL),
+    [ANIM_VAR_S] = TM_STATIC_HASH("s", 0xe5db19474a903141ULL),
+    [ANIM_VAR_D] = TM_STATIC_HASH("d", 0x17dffbc5a8f17839ULL),
+    [ANIM_VAR_RUN] = TM_STATIC_HASH("run", 0xb8961af5ed6912f5ULL),
+};
+
+// The values of `enum anim_var` last set on a state machine, see `set_anim_vars()`.
+typedef struct anim_vars_t
+{
+    tm_animation_state_machine_o *sm;
+    float values[ANIM_VAR_COUNT];
+
+    // Bit `1 << v` is set if `values[v]` is known.
+    uint32_t known_mask;
+} anim_vars_t;
+
+// Sets the `enum anim_var` variables of `n` state machines. `values` holds `ANIM_VAR_COUNT` values per state
+// machine and `cache` one entry per state machine, which remembers what was set before. Only variables that
+// changed since the last call are set. Returns the number of variables set.
+static inline uint32_t set_anim_vars(anim_vars_t *cache, tm_animation_state_machine_o *const *sms, const float *values, uint32_t n)
+{
+    uint32_t num_set = 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        anim_vars_t *c = cache + i;
+        const float *v = values + i * ANIM_VAR_COUNT;
+
+        // The state machine can be recreated, for example when the gamestate is restored.
+        if (c->sm != sms[i])
+            *c = (anim_vars_t){.sm = sms[i]};
+
+        if (!c->sm)
+            continue;
+
+        for (uint32_t var = 0; var < ANIM_VAR_COUNT; ++var)
+        {
+            if ((c->known_mask & (1u << var)) && c->values[var] == v[var])
+                continue;
+
+            tm_animation_state_machine_api->set_variable(c->sm, anim_var_names[var], v[var]);
+            c->values[var] = v[var];
+            c->known_mask |= 1u << var;
+            ++num_set;
+        }
+    }
+    return num_set;
+}
@@ -0,0 +1,269 @@
+// Records the input events, time and delta time of every tick to a compact binary log, and plays them back,
+// for example to measure the cost of the gameplay code.
+//
+// A replay is not deterministic. The gameplay code sees the recorded input and time, but PhysX steps with the
+// live frame time of the replay, so physics, and anything that depends on it, such as where the player moves
+// and what raycasts hit, can drift from the recording.
+//
+// The including file must declare `static struct tm_input_api *tm_input_api;`,
+// `static struct tm_os_api *tm_os_api;` and `static struct tm_logger_api *tm_logger_api;`, include
+// `foundation/input.h`, `foundation/os.h`, `foundation/log.h` and `foundation/carray.inl` and include
+// `input_state.inl` before this file.
+
+#include <string.h>
+
+enum input_recorder_mode
+{
+    INPUT_RECORDER_MODE_OFF,
+    INPUT_RECORDER_MODE_RECORD,
+    INPUT_RECORDER_MODE_REPLAY,
+
+    // A replay that has played all frames in the log. No more input is read.
+    INPUT_RECORDER_MODE_REPLAY_DONE,
+};
+
+// Number of recorded frames to play per simulation tick when replaying. The engines, including physics,
+// update once per simulation tick however many frames are played, so with more than one frame per tick the
+// replay only measures the gameplay code and drifts further from the recording.
+#define INPUT_RECORDER_REPLAY_FRAMES_PER_TICK 1
+
+#define INPUT_RECORDER_MAGIC 0x31434552u // "REC1"
+
+// Start of the log.
+typedef struct input_recorder_header_t
+{
+    uint32_t magic;
+    uint32_t reserved;
+
+    // Seed for the random numbers used by the simulation, so that they are the same when replaying.
+    uint64_t seed;
+} input_recorder_header_t;
+
+// Start of each frame in the log, followed by `num_events` `input_recorder_event_t`.
+typedef struct input_recorder_frame_t
+{
+    double time;
+    float dt;
+    uint32_t num_events;
+
+    // Whether the simulation had captured the mouse this frame.
+    bool captured;
+    TM_PAD(7);
+} input_recorder_frame_t;
+
+typedef struct input_recorder_event_t
+{
+    uint16_t controller_type;
+    uint16_t type;
+    uint32_t item_id;
+    tm_vec4_t data;
+} input_recorder_event_t;
+
+typedef struct input_recorder_t
+{
+    tm_allocator_i *allocator;
+    enum input_recorder_mode mode;
+    uint32_t num_frames;
+
+    // The log. Written to or read from `path`.
+    uint8_t *log;
+    uint64_t read_offset;
+    const char *path;
+
+    uint64_t seed;
+
+    // Time spent ticking the simulation while replaying, accumulated by the caller.
+    double replay_tick_seconds;
+
+    // Stand-ins for the devices of the replayed events, only `controller_type` is set.
+    tm_input_source_i keyboard_source;
+    tm_input_source_i mouse_source;
+} input_recorder_t;
+
+static inline void input_recorder__write(input_recorder_t *rec, const void *data, uint64_t size)
+{
+    const uint64_t offset = tm_carray_size(rec->log);
+    tm_carray_resize(rec->log, offset + size, rec->allocator);
+    memcpy(rec->log + offset, data, size);
+}
+
+static inline bool input_recorder__read(input_recorder_t *rec, void *data, uint64_t size)
+{
+    if (rec->read_offset + size > tm_carray_size(rec->log))
+        return false;
+    memcpy(data, rec->log + rec->read_offset, size);
+    rec->read_offset += size;
+    return true;
+}
+
+static inline bool input_recorder__load(input_recorder_t *rec)
+{
+    tm_file_o f = tm_os_api->file_io->open_input(rec->path);
+    if (!f.valid)
+        return false;
+
+    const uint64_t size = tm_os_api->file_io->size(f);
+    tm_carray_resize(rec->log, size, rec->allocator);
+    const int64_t read = tm_os_api->file_io->read(f, rec->log, size);
+    tm_os_api->file_io->close(f);
+
+    input_recorder_header_t header;
+    if (read != (int64_t)size || !input_recorder__read(rec, &header, sizeof(header)) || header.magic != INPUT_RECORDER_MAGIC)
+        return false;
+
+    rec->seed = header.seed;
+    return true;
+}
+
+// Sets up `rec` for `mode`. When replaying, the log is loaded from `path` and `rec->seed` is set to the
+// recorded seed, otherwise it is set to `seed`. If the log can't be loaded, an error is logged and the
+// recorder falls back to reading live input.
+static inline void input_recorder_init(input_recorder_t *rec, tm_allocator_i *a, enum input_recorder_mode mode, const char *path, uint64_t seed)
+{
+    *rec = (input_recorder_t){
+        .allocator = a,
+        .mode = mode,
+        .path = path,
+        .seed = seed,
+        .keyboard_source = {.controller_type = TM_INPUT_CONTROLLER_TYPE_KEYBOARD},
+        .mouse_source = {.controller_type = TM_INPUT_CONTROLLER_TYPE_MOUSE},
+    };
+
+    if (mode == INPUT_RECORDER_MODE_RECORD)
+    {
+        const input_recorder_header_t header = {.magic = INPUT_RECORDER_MAGIC, .seed = seed};
+        input_recorder__write(rec, &header, sizeof(header));
+    }
+    else if (mode == INPUT_RECORDER_MODE_REPLAY && !input_recorder__load(rec))
+    {
+        tm_logger_api->printf(TM_LOG_TYPE_ERROR, "Could not load input recording `%s`.\n", path);
+        tm_carray_resize(rec->log, 0, a);
+        rec->mode = INPUT_RECORDER_MODE_OFF;
+        rec->seed = seed;
+    }
+}
+
+// Writes the log to `path` if recording and frees the recorder.
+static inline void input_recorder_shutdown(input_recorder_t *rec)
+{
+    if (rec->mode == INPUT_RECORDER_MODE_RECORD)
+    {
+        tm_file_o f = tm_os_api->file_io->open_output(rec->path, false);
+        if (f.valid)
+        {
+            tm_os_api->file_io->write(f, rec->log, tm_carray_size(rec->log));
+            tm_os_api->file_io->close(f);
+            TM_LOG("Recorded %u frames of input to `%s`.", rec->num_frames, rec->path);
+        }
+        else
+        {
+            tm_logger_api->printf(TM_LOG_TYPE_ERROR, "Could not write input recording `%s`.\n", rec->path);
+        }
+    }
+    tm_carray_free(rec->log, rec->allocator);
+}
+
+// Updates `in` with the input of this tick. Reads live input unless replaying, and records it if recording.
+// When replaying, `time`, `dt` and `captured` are overwritten with the recorded values. Returns false when
+// a replay has run out of frames, after which the mode is `INPUT_RECORDER_MODE_REPLAY_DONE`.
+static inline bool input_recorder_update(input_recorder_t *rec, input_state_t *in, bool *captured, double *time, float *dt)
+{
+    switch (rec->mode)
+    {
+    case INPUT_RECORDER_MODE_OFF:
+    {
+        input_state_update(in, *captured);
+        return true;
+    }
+
+    case INPUT_RECORDER_MODE_RECORD:
+    {
+        input_state_begin_frame(in);
+
+        const uint64_t frame_offset = tm_carray_size(rec->log);
+        input_recorder_frame_t frame = {.time = *time, .dt = *dt, .captured = *captured};
+        input_recorder__write(rec, &frame, sizeof(frame));
+
+        tm_input_event_t events[INPUT_EVENT_BATCH];
+        while (true)
+        {
+            const uint64_t n = tm_input_api->events(in->processed_events, events, INPUT_EVENT_BATCH);
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                const tm_input_event_t *e = events + i;
+                input_state_apply_event(in, e, *captured);
+
+                // The samples only look at keyboard and mouse input.
+                if (!e->source || (e->source->controller_type != TM_INPUT_CONTROLLER_TYPE_KEYBOARD && e->source->controller_type != TM_INPUT_CONTROLLER_TYPE_MOUSE))
+                    continue;
+
+                const input_recorder_event_t re = {
+                    .controller_type = (uint16_t)e->source->controller_type,
+                    .type = (uint16_t)e->type,
+                    .item_id = (uint32_t)e->item_id,
+                    .data = e->data.f,
+                };
+                input_recorder__write(rec, &re, sizeof(re));
+                ++frame.num_events;
+            }
+
+            in->processed_events += n;
+            if (n < INPUT_EVENT_BATCH)
+                break;
+        }
+
+        memcpy(rec->log + frame_offset, &frame, sizeof(frame));
+        ++rec->num_frames;
+        return true;
+    }
+
+    case INPUT_RECORDER_MODE_REPLAY:
+    {
+        input_recorder_frame_t frame;
+        if (!input_recorder__read(rec, &frame, sizeof(frame)))
+        {
+            rec->mode = INPUT_RECORDER_MODE_REPLAY_DONE;
+            return false;
+        }
+
+        *time = frame.time;
+        *dt = frame.dt;
+        *captured = frame.captured;
+
+        input_state_begin_frame(in);
+        for (uint32_t i = 0; i < frame.num_events; ++i)
+        {
+            input_recorder_event_t re;
+            if (!input_recorder__read(rec, &re, sizeof(re)))
+            {
+                rec->mode = INPUT_RECORDER_MODE_REPLAY_DONE;
+                return false;
+            }
+
+            const tm_input_event_t e = {
+                .source = re.controller_type == TM_INPUT_CONTROLLER_TYPE_KEYBOARD ? &rec->keyboard_source : &rec->mouse_source,
+                .item_id = re.item_id,
+                .type = re.type,
+                .data.f = re.data,
+            };
+            input_state_apply_event(in, &e, frame.captured);
+        }
+        ++rec->num_frames;
+        return true;
+    }
+
+    case INPUT_RECORDER_MODE_REPLAY_DONE:
+        return false;
+    }
+    return false;
+}
+
+// Logs the number of frames replayed and the average cost of ticking them.
+static inline void input_recorder_log_replay_stats(const input_recorder_t *rec)
+{
+    if ((rec->mode != INPUT_RECORDER_MODE_REPLAY && rec->mode != INPUT_RECORDER_MODE_REPLAY_DONE) || !rec->num_frames)
+        return;
+
+    const double per_tick = rec->replay_tick_seconds / rec->num_frames;
+    TM_LOG("Replayed %u frames of `%s`: %.2f us per tick, %.0f ticks per second.", rec->num_frames, rec->path, per_tick * 1e6, per_tick > 0 ? 1.0 / per_tick : 0.0);
+}
@@ -0,0 +1,125 @@
+// Input handling shared by the gameplay samples. Reads the input events that arrived since the last call and
+// keeps the keyboard state as bitsets, with masks for the keys that went down or up this frame.
+//
+// The including file must declare `static struct tm_input_api *tm_input_api;` and include
+// `foundation/input.h` before including this file.
+
+#define INPUT_KEY_WORDS ((TM_INPUT_KEYBOARD_ITEM_COUNT + 63) / 64)
+
+// Number of events read from `tm_input_api` at a time.
+#define INPUT_EVENT_BATCH 64
+
+typedef struct input_state_t
+{
+    // One bit per keyboard item, indexed by `enum tm_input_keyboard_item`.
+    uint64_t held_keys[INPUT_KEY_WORDS];
+
+    // Keys that went down and up during the last call to `input_state_update()`.
+    uint64_t pressed_keys[INPUT_KEY_WORDS];
+    uint64_t released_keys[INPUT_KEY_WORDS];
+
+    // Accumulated mouse movement during the last call to `input_state_update()`.
+    tm_vec2_t mouse_delta;
+
+    bool left_mouse_held;
+    bool left_mouse_pressed;
+    TM_PAD(6);
+
+    // Index of the next event to read from `tm_input_api`.
+    uint64_t processed_events;
+} input_state_t;
+
+static inline bool input_key_held(const input_state_t *in, uint32_t key)
+{
+    return (in->held_keys[key / 64] >> (key % 64)) & 1;
+}
+
+static inline bool input_key_pressed(const input_state_t *in, uint32_t key)
+{
+    return (in->pressed_keys[key / 64] >> (key % 64)) & 1;
+}
+
+static inline bool input_key_released(const input_state_t *in, uint32_t key)
+{
+    return (in->released_keys[key / 64] >> (key % 64)) & 1;
+}
+
+// Maps keys to actions: returns a mask with bit `i` set if the key `action_keys[i]` is held. This lets the
+// samples test their actions with a single mask instead of looking up the keys one by one.
+static inline uint32_t input_actions_held(const input_state_t *in, const uint32_t *action_keys, uint32_t num_actions)
+{
+    uint32_t actions = 0;
+    for (uint32_t i = 0; i < num_actions; ++i)
+        actions |= (uint32_t)input_key_held(in, action_keys[i]) << i;
+    return actions;
+}
+
+static inline void input_state__set_key(input_state_t *in, uint32_t key, bool down)
+{
+    if (key >= TM_INPUT_KEYBOARD_ITEM_COUNT)
+        return;
+
+    const uint64_t bit = 1ULL << (key % 64);
+    uint64_t *held = in->held_keys + key / 64;
+    if (down && !(*held & bit))
+        in->pressed_keys[key / 64] |= bit;
+    else if (!down && (*held & bit))
+        in->released_keys[key / 64] |= bit;
+    *held = down ? (*held | bit) : (*held & ~bit);
+}
+
+// Applies one input event. If `captured` is false, only the left mouse button and escape key are tracked, so
+// that the simulation doesn't react to input meant for the rest of the editor.
+static inline void input_state_apply_event(input_state_t *in, const tm_input_event_t *e, bool captured)
+{
+    if (!e->source)
+        return;
+
+    if (e->source->controller_type == TM_INPUT_CONTROLLER_TYPE_MOUSE)
+    {
+        if (e->item_id == TM_INPUT_MOUSE_ITEM_BUTTON_LEFT)
+        {
+            const bool down = e->data.f.x > 0.5f;
+            in->left_mouse_pressed |= down && !in->left_mouse_held;
+            in->left_mouse_held = down;
+        }
+        else if (captured && e->item_id == TM_INPUT_MOUSE_ITEM_MOVE)
+        {
+            in->mouse_delta.x += e->data.f.x;
+            in->mouse_delta.y += e->data.f.y;
+        }
+    }
+    else if (e->source->controller_type == TM_INPUT_CONTROLLER_TYPE_KEYBOARD && e->type == TM_INPUT_EVENT_TYPE_DATA_CHANGE)
+    {
+        if (captured || e->item_id == TM_INPUT_KEYBOARD_ITEM_ESCAPE)
+            input_state__set_key(in, (uint32_t)e->item_id, e->data.f.x == 1.0f);
+    }
+}
+
+// Clears the per-frame state (pressed and released keys, mouse movement).
+static inline void input_state_begin_frame(input_state_t *in)
+{
+    for (uint32_t i = 0; i < INPUT_KEY_WORDS; ++i)
+        in->pressed_keys[i] = in->released_keys[i] = 0;
+    in->mouse_delta = (tm_vec2_t){0};
+    in->left_mouse_pressed = false;
+}
+
+// Reads all input events since the last call and applies them to `in`. Events are copied out of the input
+// ring in batches on the stack, nothing is allocated.
+static inline void input_state_update(input_state_t *in, bool captured)
+{
+    input_state_begin_frame(in);
+
+    tm_input_event_t events[INPUT_EVENT_BATCH];
+    while (true)
+    {
+        const uint64_t n = tm_input_api->events(in->processed_events, events, INPUT_EVENT_BATCH);
+        for (uint64_t i = 0; i < n; ++i)
+            input_state_apply_event(in, events + i, captured);
+
+        in->processed_events += n;
+        if (n < INPUT_EVENT_BATCH)
+            break;
+    }
+}
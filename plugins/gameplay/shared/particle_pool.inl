@@ -0,0 +1,91 @@
+// Pool of particle effect entities that are reused instead of created for every spawn. The effects are
+// created once, up front, and are disabled while they are not shown. Spawning an effect takes a disabled one,
+// or the oldest one if all of them are shown, and restarts it, so that it emits again from the start.
+//
+// How an effect is restarted and disabled is up to the including file, see `particle_effect_i`.
+//
+// The including file must include `plugins/entity/entity.h` before including this file.
+
+// Most effects in a pool, which is also the most effects that can show at once.
+#define PARTICLE_POOL_SIZE 4
+
+// Restarts and disables the effects of a `particle_pool_t`.
+typedef struct particle_effect_i
+{
+    void *inst;
+
+    // Moves the effect `e` to `pos` and restarts it. A restarted effect emits as if it had just been created,
+    // whether it was disabled or still showing.
+    void (*restart)(void *inst, tm_entity_t e, tm_vec3_t pos);
+
+    // Disables the effect `e`, so that it neither simulates nor draws until it is restarted.
+    void (*disable)(void *inst, tm_entity_t e);
+} particle_effect_i;
+
+typedef struct particle_pool_t
+{
+    tm_entity_t entities[PARTICLE_POOL_SIZE];
+
+    // Time at which each effect was spawned. Only valid if the effect is active.
+    double spawn_time[PARTICLE_POOL_SIZE];
+
+    uint32_t num_entities;
+
+    bool active[PARTICLE_POOL_SIZE];
+} particle_pool_t;
+
+// Adds the effect `e` to the pool and disables it. Returns false if the pool is full.
+static inline bool particle_pool_add(particle_pool_t *pool, const particle_effect_i *effect, tm_entity_t e)
+{
+    if (pool->num_entities == PARTICLE_POOL_SIZE)
+        return false;
+
+    const uint32_t idx = pool->num_entities++;
+    pool->entities[idx] = e;
+    pool->active[idx] = false;
+    effect->disable(effect->inst, e);
+    return true;
+}
+
+// Takes an effect from the pool and restarts it at `pos`. If all effects are in use, the oldest one is taken.
+// Returns a nil entity if the pool is empty.
+static inline tm_entity_t particle_pool_spawn(particle_pool_t *pool, const particle_effect_i *effect, tm_vec3_t pos, double t)
+{
+    if (!pool->num_entities)
+        return (tm_entity_t){0};
+
+    uint32_t idx = UINT32_MAX;
+    uint32_t oldest = 0;
+    for (uint32_t i = 0; i < pool->num_entities; ++i)
+    {
+        if (!pool->active[i])
+        {
+            idx = i;
+            break;
+        }
+
+        if (pool->spawn_time[i] < pool->spawn_time[oldest])
+            oldest = i;
+    }
+
+    if (idx == UINT32_MAX)
+        idx = oldest;
+
+    pool->active[idx] = true;
+    pool->spawn_time[idx] = t;
+    effect->restart(effect->inst, pool->entities[idx], pos);
+    return pool->entities[idx];
+}
+
+// Disables the effects that have been shown for `lifetime` seconds and returns them to the pool.
+static inline void particle_pool_recycle(particle_pool_t *pool, const particle_effect_i *effect, double t, double lifetime)
+{
+    for (uint32_t i = 0; i < pool->num_entities; ++i)
+    {
+        if (pool->active[i] && t - pool->spawn_time[i] >= lifetime)
+        {
+            pool->active[i] = false;
+            effect->disable(effect->inst, pool->entities[i]);
+        }
+    }
+}
@@ -0,0 +1,14 @@
+// SplitMix64 random number generator. It is small and fast, and gives the same numbers for the same seed on
+// every platform, so a seed recorded with a session (see `input_recorder.inl`) or fixed in a benchmark
+// reproduces the same run.
+//
+// The including file must include `foundation/api_types.h` before including this file.
+
+// Advances `state` and returns the next random number.
+static inline uint64_t next_random(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
@@ -0,0 +1,114 @@
+// Batched physics raycasts shared by the gameplay samples. Gameplay code queues the rays it needs with
+// `raycast_batch_add()` while it decides what to do, `raycast_batch_execute()` runs them all in one go and
+// the next phase reads the hits with `raycast_batch_result()`. Results stay valid until
+// `raycast_batch_reset()`, which is typically called at the start of the next tick.
+//
+// `tm_physx_scene_api` has no batched scene query, so the rays are run one after the other, but from a
+// single place in the tick, which shows up as one profiler scope with the cost of all rays of the frame.
+//
+// The including file must declare `static struct tm_physx_scene_api *tm_physx_scene_api;`,
+// `static struct tm_profiler_api *tm_profiler_api;`, `static struct tm_os_api *tm_os_api;` and
+// `static struct tm_logger_api *tm_logger_api;`, include `plugins/physx/physx_scene.h`,
+// `foundation/profiler.h`, `foundation/os.h`, `foundation/log.h` and `foundation/carray.inl` before
+// including this file.
+
+typedef struct raycast_request_t
+{
+    tm_vec3_t from;
+    tm_vec3_t dir;
+    float distance;
+    TM_PAD(4);
+    tm_tt_id_t collision_id;
+} raycast_request_t;
+
+typedef struct raycast_batch_t
+{
+    tm_allocator_i *allocator;
+
+    // Queued rays and, once executed, their results. `results` has one entry per executed request.
+    raycast_request_t *requests;
+    tm_physx_raycast_t *results;
+
+    // Size and duration of the last batch, and the largest batch so far.
+    uint32_t last_batch_size;
+    uint32_t peak_batch_size;
+    double last_batch_seconds;
+
+    // Totals since `raycast_batch_init()` or `raycast_batch_reset_stats()`.
+    uint64_t total_rays;
+    double total_seconds;
+} raycast_batch_t;
+
+static inline void raycast_batch_init(raycast_batch_t *b, tm_allocator_i *a)
+{
+    *b = (raycast_batch_t){.allocator = a};
+}
+
+static inline void raycast_batch_free(raycast_batch_t *b)
+{
+    tm_carray_free(b->requests, b->allocator);
+    tm_carray_free(b->results, b->allocator);
+}
+
+// Drops all requests and results. Keeps the memory around for the next batch.
+static inline void raycast_batch_reset(raycast_batch_t *b)
+{
+    tm_carray_resize(b->requests, 0, b->allocator);
+    tm_carray_resize(b->results, 0, b->allocator);
+}
+
+// Queues a ray and returns the index to read its result with.
+static inline uint32_t raycast_batch_add(raycast_batch_t *b, tm_vec3_t from, tm_vec3_t dir, float distance, tm_tt_id_t collision_id)
+{
+    const raycast_request_t r = {.from = from, .dir = dir, .distance = distance, .collision_id = collision_id};
+    tm_carray_push(b->requests, r, b->allocator);
+    return (uint32_t)tm_carray_size(b->requests) - 1;
+}
+
+// Runs the requests that haven't been run yet.
+static void raycast_batch_execute(raycast_batch_t *b, tm_physx_scene_o *physx_scene)
+{
+    TM_PROFILER_BEGIN_FUNC_SCOPE();
+    const tm_clock_o start = tm_os_api->time->now();
+
+    const uint32_t first = (uint32_t)tm_carray_size(b->results);
+    const uint32_t n = (uint32_t)tm_carray_size(b->requests);
+    tm_carray_resize(b->results, n, b->allocator);
+
+    for (uint32_t i = first; i < n; ++i)
+    {
+        const raycast_request_t *r = b->requests + i;
+        b->results[i] = tm_physx_scene_api->raycast(physx_scene, r->from, r->dir, r->distance, r->collision_id, (tm_physx_raycast_flags_t){0}, 0, 0);
+    }
+
+    b->last_batch_size = n - first;
+    b->peak_batch_size = tm_max(b->peak_batch_size, b->last_batch_size);
+    b->last_batch_seconds = tm_os_api->time->delta(tm_os_api->time->now(), start);
+    b->total_rays += b->last_batch_size;
+    b->total_seconds += b->last_batch_seconds;
+    TM_PROFILER_END_FUNC_SCOPE();
+}
+
+// Returns the result of request `i`. The request must have been executed.
+static inline const tm_physx_raycast_t *raycast_batch_result(const raycast_batch_t *b, uint32_t i)
+{
+    return b->results + i;
+}
+
+// Restarts the peak and totals, for measuring a new stretch of ticks.
+static inline void raycast_batch_reset_stats(raycast_batch_t *b)
+{
+    b->peak_batch_size = 0;
+    b->total_rays = 0;
+    b->total_seconds = 0;
+}
+
+// Logs the rays run and the time spent running them per tick, given that the totals cover `num_ticks`
+// ticks.
+static inline void raycast_batch_log_stats(const raycast_batch_t *b, uint32_t num_ticks)
+{
+    if (!num_ticks)
+        return;
+
+    TM_LOG("Raycasts: %.1f rays per tick (peak %u), %.2f us per tick, %.3f us per ray.", (double)b->total_rays / num_ticks, b->peak_batch_size, b->total_seconds / num_ticks * 1e6, b->total_rays ? b->total_seconds / (double)b->total_rays * 1e6 : 0.0);
+}
@@ -46,20 +46,40 @@ static struct tm_gamestate_api *tm_gamestate_api;
 #include <plugins/simulation/simulation_entry.h>
 #include <plugins/ui/ui.h>
 
+#include <foundation/carray.inl>
 #include <foundation/math.inl>
+
+#include "../shared/anim_vars.inl"
+#include "../shared/input_state.inl"
+#include "../shared/particle_pool.inl"
 #include <plugins/creation_graph/creation_graph_output.inl>
 
 #include <stddef.h>
 #include <stdio.h>
+#include <string.h>
+
+// How long a spawned particle effect is shown before it goes back to the pool, in seconds. The effect emits a
+// single burst when it starts, which has died out by then.
+#define PARTICLE_LIFETIME 4.0
 
-typedef struct input_state_t
+// Offset of a shader constant, as found by `tm_shader_api->lookup_constant()`. `offset` is UINT32_MAX if the
+// shader doesn't have the constant.
+typedef struct constant_offset_t
 {
-    tm_vec2_t mouse_delta;
-    bool held_keys[TM_INPUT_KEYBOARD_ITEM_COUNT];
-    bool left_mouse_held;
-    bool left_mouse_pressed;
-    TM_PAD(1);
-} input_state_t;
+    tm_strhash_t name;
+    uint32_t offset;
+    TM_PAD(4);
+} constant_offset_t;
+
+// A shader constant update waiting for `private__flush_shader_constants()`. The data is stored at
+// `data_offset` in `tm_simulation_state_o.constant_data`, `update.data` is set when flushing.
+typedef struct pending_constant_t
+{
+    tm_shader_io_o *io;
+    tm_shader_constant_update_t update;
+    uint32_t data_offset;
+    TM_PAD(4);
+} pending_constant_t;
 
 struct tm_simulation_state_o
 {
@@ -84,11 +104,25 @@ struct tm_simulation_state_o
     tm_entity_t player_camera_pivot;
     tm_entity_t checkpoint_sphere;
     tm_vec3_t checkpoints_positions[8];
-    uint64_t processed_events;
 
+    // Particle effects spawned at the checkpoints. All entities are created once, in `start()`, so the number
+    // of entities doesn't grow over a session.
     tm_tt_id_t particle_entity;
+    particle_pool_t particles;
+    particle_effect_i particle_effect;
     tm_renderer_backend_i *rb;
 
+    // Shader constant offsets looked up in `constant_shader` so far. They are dropped when a draw call with
+    // another shader comes along, such as after the effect's shader has been recompiled. There is only a
+    // handful of constants, so this is searched linearly.
+    struct tm_shader_o *constant_shader;
+    constant_offset_t *constant_offsets;
+
+    // Shader constant updates made this frame, submitted together at the end of `tick()`.
+    pending_constant_t *pending_constants;
+    uint8_t *constant_data;
+    tm_shader_constant_update_t *constant_updates;
+
     uint32_t current_checkpoint;
     float camera_tilt;
 
@@ -99,6 +133,9 @@ struct tm_simulation_state_o
     // For giving some extra time to press jump.
     double last_standing_time;
 
+    // Animation variables last set on the player's state machine.
+    anim_vars_t player_anim_vars;
+
     // Component types
     tm_component_type_t asm_component;
     tm_component_type_t mover_component;
@@ -161,6 +198,48 @@ static void deserialize(void *d, void *s)
     dest->last_standing_time = source->last_standing_time;
 }
 
+// Particle effects are disabled by removing their render component, which destroys the creation graph
+// instance that simulates and draws the particles. Restarting an effect loads a new render component from
+// the effect's asset, whose creation graph instance runs its init event and emits a new burst.
+static void particle_effect__restart(void *inst, tm_entity_t e, tm_vec3_t pos)
+{
+    tm_simulation_state_o *state = inst;
+    tm_set_position(state->trans_mgr, e, pos);
+
+    if (tm_entity_api->read_component(state->entity_ctx, e, state->render_component))
+        tm_entity_api->remove_component(state->entity_ctx, e, state->render_component);
+
+    void *rc = tm_entity_api->add_component(state->entity_ctx, e, state->render_component);
+    const tm_component_i *com = tm_entity_api->component(state->entity_ctx, state->render_component);
+    if (rc && com && com->asset_loaded)
+        com->asset_loaded(com->manager, 0, e, rc);
+}
+
+static void particle_effect__disable(void *inst, tm_entity_t e)
+{
+    tm_simulation_state_o *state = inst;
+    tm_entity_api->remove_component(state->entity_ctx, e, state->render_component);
+}
+
+// Creates the entities of the particle pool, disabled.
+static void particle_pool_prewarm(tm_simulation_state_o *state)
+{
+    state->particle_effect = (particle_effect_i){
+        .inst = state,
+        .restart = particle_effect__restart,
+        .disable = particle_effect__disable,
+    };
+
+    if (!state->particle_entity.u64)
+        return;
+
+    for (uint32_t i = 0; i < PARTICLE_POOL_SIZE; ++i)
+    {
+        const tm_entity_t e = tm_entity_api->create_entity_from_asset(state->entity_ctx, state->particle_entity);
+        particle_pool_add(&state->particles, &state->particle_effect, e);
+    }
+}
+
 static tm_simulation_state_o *start(tm_simulation_start_args_t *args)
 {
     tm_simulation_state_o *state = tm_alloc(args->allocator, sizeof(*state));
@@ -187,6 +266,7 @@ static tm_simulation_state_o *start(tm_simulation_start_args_t *args)
     state->checkpoint_sphere = tm_tag_component_api->find_first(state->tag_mgr, TM_STATIC_HASH("checkpoint", 0x76169e4aa68e805dULL));
     state->camera_tilt = 3.18f;
     state->particle_entity = tm_the_truth_assets_api->asset_object_from_path(state->tt, state->asset_root, "vfx/particles.entity");
+    particle_pool_prewarm(state);
 
     const tm_entity_t camera = tm_tag_component_api->find_first(state->tag_mgr, TM_STATIC_HASH("camera", 0x60ed8c3931822dc7ULL));
     tm_simulation_api->set_camera(state->simulation_ctx, camera);
@@ -223,16 +303,91 @@ static tm_simulation_state_o *start(tm_simulation_start_args_t *args)
 static void stop(tm_simulation_state_o *state, struct tm_entity_commands_o *commands)
 {
     tm_allocator_i a = *state->allocator;
+    tm_carray_free(state->constant_offsets, &a);
+    tm_carray_free(state->pending_constants, &a);
+    tm_carray_free(state->constant_data, &a);
+    tm_carray_free(state->constant_updates, &a);
     tm_free(&a, state, sizeof(*state));
 }
 
-static void private__set_shader_constant(tm_shader_io_o *io, tm_renderer_resource_command_buffer_o *res_buf, const tm_shader_constant_buffer_instance_t *instance, tm_strhash_t name, const void *data, uint32_t data_size)
+// Returns the offset of constant `name` in `shader`, or UINT32_MAX if there is no such constant.
+static uint32_t private__constant_offset(tm_simulation_state_o *state, struct tm_shader_o *shader, tm_shader_io_o *io, tm_strhash_t name)
 {
+    if (shader != state->constant_shader)
+    {
+        tm_carray_resize(state->constant_offsets, 0, state->allocator);
+        state->constant_shader = shader;
+    }
+
+    for (const constant_offset_t *c = state->constant_offsets; c != tm_carray_end(state->constant_offsets); ++c)
+    {
+        if (TM_STRHASH_U64(c->name) == TM_STRHASH_U64(name))
+            return c->offset;
+    }
+
     tm_shader_constant_t constant;
     uint32_t constant_offset;
+    if (!tm_shader_api->lookup_constant(io, name, &constant, &constant_offset))
+        constant_offset = UINT32_MAX;
+
+    tm_carray_push(state->constant_offsets, ((constant_offset_t){.name = name, .offset = constant_offset}), state->allocator);
+    return constant_offset;
+}
 
-    if (tm_shader_api->lookup_constant(io, name, &constant, &constant_offset))
-        tm_shader_api->update_constants(io, res_buf, &(tm_shader_constant_update_t){.instance_id = instance->instance_id, .constant_offset = constant_offset, .num_bytes = data_size, .data = data}, 1);
+// Queues an update of a shader constant. The data is copied, so it doesn't need to outlive the call.
+static void private__set_shader_constant(tm_simulation_state_o *state, struct tm_shader_o *shader, const tm_shader_constant_buffer_instance_t *instance, tm_strhash_t name, const void *data, uint32_t data_size)
+{
+    tm_shader_io_o *io = tm_shader_api->shader_io(shader);
+    const uint32_t constant_offset = private__constant_offset(state, shader, io, name);
+    if (constant_offset == UINT32_MAX)
+        return;
+
+    const uint32_t data_offset = (uint32_t)tm_carray_size(state->constant_data);
+    tm_carray_resize(state->constant_data, data_offset + data_size, state->allocator);
+    memcpy(state->constant_data + data_offset, data, data_size);
+
+    const pending_constant_t pending = {
+        .io = io,
+        .update = {.instance_id = instance->instance_id, .constant_offset = constant_offset, .num_bytes = data_size},
+        .data_offset = data_offset,
+    };
+    tm_carray_push(state->pending_constants, pending, state->allocator);
+}
+
+// Submits the shader constant updates queued this frame in a single resource command buffer.
+static void private__flush_shader_constants(tm_simulation_state_o *state)
+{
+    const uint32_t n = (uint32_t)tm_carray_size(state->pending_constants);
+    if (!n)
+        return;
+
+    tm_carray_resize(state->constant_updates, n, state->allocator);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        state->constant_updates[i] = state->pending_constants[i].update;
+        state->constant_updates[i].data = state->constant_data + state->pending_constants[i].data_offset;
+    }
+
+    tm_renderer_resource_command_buffer_o *res_buf;
+    state->rb->create_resource_command_buffers(state->rb->inst, &res_buf, 1);
+
+    // `update_constants()` takes the updates of one shader IO at a time, so send each run of updates to the
+    // same IO in one call.
+    uint32_t first = 0;
+    for (uint32_t i = 1; i <= n; ++i)
+    {
+        if (i == n || state->pending_constants[i].io != state->pending_constants[first].io)
+        {
+            tm_shader_api->update_constants(state->pending_constants[first].io, res_buf, state->constant_updates + first, i - first);
+            first = i;
+        }
+    }
+
+    state->rb->submit_resource_command_buffers(state->rb->inst, &res_buf, 1);
+    state->rb->destroy_resource_command_buffers(state->rb->inst, &res_buf, 1);
+
+    tm_carray_resize(state->pending_constants, 0, state->allocator);
+    tm_carray_resize(state->constant_data, 0, state->allocator);
 }
 
 static void private__adjust_effect_start_color(tm_simulation_state_o *state, tm_entity_t p, tm_vec3_t color)
@@ -242,57 +397,13 @@ static void private__adjust_effect_start_color(tm_simulation_state_o *state, tm_
     const tm_creation_graph_draw_call_data_t *draw = tm_render_component_api->draw_call(rc, TM_STATIC_HASH("vfx", 0xfc741b5732202063ULL));
 
     if (draw && draw->shader)
-    {
-        tm_renderer_resource_command_buffer_o *res_buf;
-        state->rb->create_resource_command_buffers(state->rb->inst, &res_buf, 1);
-
-        private__set_shader_constant(tm_shader_api->shader_io(draw->shader), res_buf, &draw->cbuffer, TM_STATIC_HASH("start_color", 0x78037e459ae53b07ULL), &color, sizeof(color));
-
-        state->rb->submit_resource_command_buffers(state->rb->inst, &res_buf, 1);
-        state->rb->destroy_resource_command_buffers(state->rb->inst, &res_buf, 1);
-    }
+        private__set_shader_constant(state, draw->shader, &draw->cbuffer, TM_STATIC_HASH("start_color", 0x78037e459ae53b07ULL), &color, sizeof(color));
 }
 
 static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
 {
-    // Reset per-frame input
-    state->input.mouse_delta.x = state->input.mouse_delta.y = 0;
-    state->input.left_mouse_pressed = false;
-
     // Read input
-    tm_input_event_t events[32];
-    while (true)
-    {
-        uint64_t n = tm_input_api->events(state->processed_events, events, 32);
-        for (uint64_t i = 0; i < n; ++i)
-        {
-            const tm_input_event_t *e = events + i;
-            if (e->source && e->source->controller_type == TM_INPUT_CONTROLLER_TYPE_MOUSE)
-            {
-                if (e->item_id == TM_INPUT_MOUSE_ITEM_BUTTON_LEFT)
-                {
-                    const bool down = e->data.f.x > 0.5f;
-                    state->input.left_mouse_pressed = down && !state->input.left_mouse_held;
-                    state->input.left_mouse_held = down;
-                }
-                else if (e->item_id == TM_INPUT_MOUSE_ITEM_MOVE)
-                {
-                    state->input.mouse_delta.x += e->data.f.x;
-                    state->input.mouse_delta.y += e->data.f.y;
-                }
-            }
-            if (e->source && e->source->controller_type == TM_INPUT_CONTROLLER_TYPE_KEYBOARD)
-            {
-                if (e->type == TM_INPUT_EVENT_TYPE_DATA_CHANGE)
-                {
-                    state->input.held_keys[e->item_id] = e->data.f.x == 1.0f;
-                }
-            }
-        }
-        state->processed_events += n;
-        if (n < 32)
-            break;
-    }
+    input_state_update(&state->input, true);
 
     // Capture mouse
     if (args->ui)
@@ -302,7 +413,7 @@ static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
             state->mouse_captured = true;
         }
 
-        if ((args->running_in_editor && state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_ESCAPE]) || !tm_ui_api->window_has_focus(args->ui))
+        if ((args->running_in_editor && input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_ESCAPE)) || !tm_ui_api->window_has_focus(args->ui))
         {
             state->mouse_captured = false;
             struct tm_application_o *app = tm_application_api->application();
@@ -329,7 +440,7 @@ static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
     if (state->mouse_captured)
     {
         // Exit on ESC
-        if (!args->running_in_editor && state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_ESCAPE])
+        if (!args->running_in_editor && input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_ESCAPE))
         {
             struct tm_application_o *app = tm_application_api->application();
             tm_application_api->exit(app, false);
@@ -351,14 +462,17 @@ static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
         // Control animation state machine using input
         tm_animation_state_machine_component_t *smc = tm_entity_api->write_component(state->entity_ctx, state->player, state->asm_component);
         tm_animation_state_machine_o *sm = smc->state_machine;
-        tm_animation_state_machine_api->set_variable(sm, TM_STATIC_HASH("w", 0x22727cb14c3bb41dULL), (float)state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_W]);
-        tm_animation_state_machine_api->set_variable(sm, TM_STATIC_HASH("a", 0x71717d2d36b6b11ULL), (float)state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_A]);
-        tm_animation_state_machine_api->set_variable(sm, TM_STATIC_HASH("s", 0xe5db19474a903141ULL), (float)state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_S]);
-        tm_animation_state_machine_api->set_variable(sm, TM_STATIC_HASH("d", 0x17dffbc5a8f17839ULL), (float)state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_D]);
-        tm_animation_state_machine_api->set_variable(sm, TM_STATIC_HASH("run", 0xb8961af5ed6912f5ULL), (float)state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_LEFTSHIFT]);
+        const float anim_values[ANIM_VAR_COUNT] = {
+            [ANIM_VAR_W] = (float)input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_W),
+            [ANIM_VAR_A] = (float)input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_A),
+            [ANIM_VAR_S] = (float)input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_S),
+            [ANIM_VAR_D] = (float)input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_D),
+            [ANIM_VAR_RUN] = (float)input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_LEFTSHIFT),
+        };
+        set_anim_vars(&state->player_anim_vars, &sm, anim_values, 1);
 
         const bool can_jump = args->time < state->last_standing_time + 0.2f;
-        if (can_jump && state->input.held_keys[TM_INPUT_KEYBOARD_ITEM_SPACE])
+        if (can_jump && input_key_held(&state->input, TM_INPUT_KEYBOARD_ITEM_SPACE))
         {
             tm_animation_state_machine_api->event(sm, TM_STATIC_HASH("jump", 0x7b98bf53d1dceae8ULL));
             player_mover->velocity.y += 6;
@@ -366,6 +480,9 @@ static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
         }
     }
 
+    // Return finished particle effects to the pool.
+    particle_pool_recycle(&state->particles, &state->particle_effect, args->time, PARTICLE_LIFETIME);
+
     // Check player against checkpoint
     const tm_vec3_t sphere_pos = tm_get_position(state->trans_mgr, state->checkpoint_sphere);
     const tm_vec3_t player_pos = tm_get_position(state->trans_mgr, state->player);
@@ -378,13 +495,10 @@ static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
         if (state->current_checkpoint == 8)
             state->current_checkpoint = 0;
 
-        if (state->particle_entity.u64)
+        // Spawn particle effect at position of next checkpoint.
+        const tm_entity_t p = particle_pool_spawn(&state->particles, &state->particle_effect, state->checkpoints_positions[state->current_checkpoint], args->time);
+        if (p.u64)
         {
-            // Spawn particle effect at position of next checkpoint.
-            tm_entity_t p = tm_entity_api->create_entity_from_asset(state->entity_ctx, state->particle_entity);
-            // Set particle spawn location to next check point.
-            tm_set_position(state->trans_mgr, p, state->checkpoints_positions[state->current_checkpoint]);
-
             // Make up an arbitrary color based on the direction the player entered the last check point.
             tm_vec3_t color = tm_vec3_normalize(tm_vec3_sub(sphere_pos, player_pos));
             color = (tm_vec3_t){fabsf(color.x), fabsf(color.y), fabsf(color.z)};
@@ -394,6 +508,9 @@ static void tick(tm_simulation_state_o *state, tm_simulation_frame_args_t *args)
         tm_set_position(state->trans_mgr, state->checkpoint_sphere, state->checkpoints_positions[state->current_checkpoint]);
     }
 
+    // Send the shader constant changes of this frame to the renderer.
+    private__flush_shader_constants(state);
+
     // UI
     if (args->ui)
     {
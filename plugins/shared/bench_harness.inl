@@ -0,0 +1,546 @@
+// Stand-ins for the parts of The Machinery that the benchmark targets run sample code against, so that a
+// benchmark is a plain console program: no editor, no GPU and no engine plugins. A benchmark includes the
+// `.c` file of the sample it measures after this file, sets the sample's API pointers to the stand-ins below
+// and calls the sample's own engine and update functions.
+//
+// The stand-ins only do what the samples need while simulating:
+//
+// * `bench_allocator()` is a `tm_allocator_i` on top of `realloc()` that counts allocations.
+// * `TM_INIT_TEMP_ALLOCATOR()` makes a `bench_temp_allocator_t` instead of a real temp allocator. It takes
+//   its memory from `bench_allocator()` and frees it all in `TM_SHUTDOWN_TEMP_ALLOCATOR()`.
+// * `bench_os_api()` and `bench_logger_api()` provide the clock and the log.
+// * `bench_entity_api()` is a minimal entity context. Entities are indices and components are stored in one
+//   array per component type, indexed by entity, so that a range of entities created together can be
+//   handed to an engine as a single update array, see `bench_engine_update_set()`.
+// * `bench_parse_args()`, `bench_summarize()` and `bench_print_summary()` parse the command line and report
+//   the measurements in the same way in every benchmark.
+//
+// Profiler scopes compile to nothing, so that they don't need a `tm_profiler_api`.
+//
+// The including file must include `foundation/allocator.h`, `foundation/log.h`, `foundation/os.h`,
+// `foundation/murmurhash64a.inl` and `plugins/entity/entity.h` before including this file.
+
+#include <foundation/carray.inl>
+#include <foundation/profiler.h>
+#include <foundation/temp_allocator.h>
+
+#undef TM_PROFILER_BEGIN_FUNC_SCOPE
+#define TM_PROFILER_BEGIN_FUNC_SCOPE()
+#undef TM_PROFILER_END_FUNC_SCOPE
+#define TM_PROFILER_END_FUNC_SCOPE()
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ---
+// Allocator
+
+// Counters of `bench_allocator`. Reset them with `bench_allocator_reset_stats()` before the part to measure.
+typedef struct bench_allocator_stats_t
+{
+    uint64_t num_allocs;
+    uint64_t num_reallocs;
+    uint64_t num_frees;
+    uint64_t bytes_allocated;
+} bench_allocator_stats_t;
+
+static bench_allocator_stats_t bench_allocator_stats;
+
+static inline void *bench_allocator__realloc(tm_allocator_i *a, void *ptr, uint64_t old_size, uint64_t new_size, const char *file, uint32_t line)
+{
+    if (!new_size)
+    {
+        if (ptr)
+            ++bench_allocator_stats.num_frees;
+        free(ptr);
+        return 0;
+    }
+
+    if (ptr)
+        ++bench_allocator_stats.num_reallocs;
+    else
+        ++bench_allocator_stats.num_allocs;
+    if (new_size > old_size)
+        bench_allocator_stats.bytes_allocated += new_size - old_size;
+    return realloc(ptr, new_size);
+}
+
+static inline tm_allocator_i *bench_allocator(void)
+{
+    static tm_allocator_i a = {
+        .realloc = bench_allocator__realloc,
+    };
+    return &a;
+}
+
+static inline void bench_allocator_reset_stats(void)
+{
+    bench_allocator_stats = (bench_allocator_stats_t){0};
+}
+
+// Number of calls that allocated or grew memory since the last `bench_allocator_reset_stats()`.
+static inline uint64_t bench_allocator_num_allocations(void)
+{
+    return bench_allocator_stats.num_allocs + bench_allocator_stats.num_reallocs;
+}
+
+// ---
+// Temp allocator
+
+#define BENCH_TEMP_ALLOCATOR_MAX_BLOCKS 64
+
+// Arena that stands in for a temp allocator. Memory is only given back when the arena is freed, as with a
+// real temp allocator, so growing an array leaves its old block in the arena.
+typedef struct bench_temp_allocator_t
+{
+    tm_allocator_i i;
+    void *blocks[BENCH_TEMP_ALLOCATOR_MAX_BLOCKS];
+    uint64_t sizes[BENCH_TEMP_ALLOCATOR_MAX_BLOCKS];
+    uint32_t num_blocks;
+    TM_PAD(4);
+} bench_temp_allocator_t;
+
+static inline void *bench_temp_allocator__realloc(tm_allocator_i *a, void *ptr, uint64_t old_size, uint64_t new_size, const char *file, uint32_t line)
+{
+    bench_temp_allocator_t *ta = (bench_temp_allocator_t *)a->inst;
+    if (new_size <= old_size)
+        return new_size ? ptr : 0;
+
+    if (ta->num_blocks == BENCH_TEMP_ALLOCATOR_MAX_BLOCKS)
+    {
+        fprintf(stderr, "%s(%u): Bench temp allocator is full (%u blocks).\n", file, line, ta->num_blocks);
+        exit(1);
+    }
+
+    void *p = bench_allocator()->realloc(bench_allocator(), 0, 0, new_size, file, line);
+    if (ptr)
+        memcpy(p, ptr, old_size);
+    ta->blocks[ta->num_blocks] = p;
+    ta->sizes[ta->num_blocks] = new_size;
+    ++ta->num_blocks;
+    return p;
+}
+
+static inline tm_allocator_i *bench_temp_allocator_init(bench_temp_allocator_t *ta)
+{
+    *ta = (bench_temp_allocator_t){
+        .i = {
+            .inst = (struct tm_allocator_o *)ta,
+            .realloc = bench_temp_allocator__realloc,
+        },
+    };
+    return &ta->i;
+}
+
+static inline void bench_temp_allocator_free(bench_temp_allocator_t *ta)
+{
+    for (uint32_t i = 0; i < ta->num_blocks; ++i)
+        bench_allocator()->realloc(bench_allocator(), ta->blocks[i], ta->sizes[i], 0, __FILE__, __LINE__);
+    ta->num_blocks = 0;
+}
+
+#undef TM_INIT_TEMP_ALLOCATOR
+#define TM_INIT_TEMP_ALLOCATOR(ta)       \
+    bench_temp_allocator_t ta##_bench; \
+    tm_allocator_i *ta = bench_temp_allocator_init(&ta##_bench)
+#undef TM_SHUTDOWN_TEMP_ALLOCATOR
+#define TM_SHUTDOWN_TEMP_ALLOCATOR(ta) bench_temp_allocator_free(&ta##_bench)
+#undef tm_carray_temp_resize
+#define tm_carray_temp_resize(a, n, ta) tm_carray_resize(a, n, ta)
+
+// ---
+// Clock and log
+
+static inline uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline tm_clock_o bench_os__now(void)
+{
+    tm_clock_o c = {0};
+    const uint64_t ns = bench_now_ns();
+    memcpy(&c, &ns, sizeof(ns));
+    return c;
+}
+
+static inline double bench_os__delta(tm_clock_o to, tm_clock_o from)
+{
+    uint64_t to_ns, from_ns;
+    memcpy(&to_ns, &to, sizeof(to_ns));
+    memcpy(&from_ns, &from, sizeof(from_ns));
+    return (double)(int64_t)(to_ns - from_ns) * 1e-9;
+}
+
+static inline struct tm_os_api *bench_os_api(void)
+{
+    static struct tm_os_time_api time_api = {
+        .now = bench_os__now,
+        .delta = bench_os__delta,
+    };
+    static struct tm_os_api api = {
+        .time = &time_api,
+    };
+    return &api;
+}
+
+static inline int bench_logger__printf(enum tm_log_type log_type, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const int res = vfprintf(log_type == TM_LOG_TYPE_ERROR ? stderr : stdout, format, args);
+    va_end(args);
+    return res;
+}
+
+static inline struct tm_logger_api *bench_logger_api(void)
+{
+    static struct tm_logger_api api = {
+        .printf = bench_logger__printf,
+    };
+    return &api;
+}
+
+// ---
+// Entity context
+
+#define BENCH_MAX_COMPONENT_TYPES 8
+#define BENCH_MAX_ENGINES 8
+
+typedef struct bench_component_type_t
+{
+    tm_component_i i;
+    uint64_t name_hash;
+
+    // `i.bytes` per entity, for every entity of the context. `has[e]` is set if entity `e` has the component.
+    uint8_t *data;
+    bool *has;
+} bench_component_type_t;
+
+// Entity `e` is `(tm_entity_t){.u64 = e}`. Entity 0 is never created, so that a zero handle is never alive.
+struct tm_entity_context_o
+{
+    uint32_t num_entities;
+    uint32_t capacity;
+
+    bench_component_type_t types[BENCH_MAX_COMPONENT_TYPES];
+    uint32_t num_types;
+
+    tm_engine_i engines[BENCH_MAX_ENGINES];
+    uint32_t num_engines;
+
+    // Number of `notify()` calls and entities passed to them.
+    uint64_t num_notify_calls;
+    uint64_t num_notified;
+};
+
+// Creates a context with room for `capacity` entities.
+static inline tm_entity_context_o *bench_entity_context_create(uint32_t capacity)
+{
+    tm_entity_context_o *ctx = calloc(1, sizeof(*ctx));
+    ctx->capacity = capacity + 1;
+    ctx->num_entities = 1;
+    return ctx;
+}
+
+static inline void bench_entity_context_destroy(tm_entity_context_o *ctx)
+{
+    for (uint32_t i = 0; i < ctx->num_types; ++i)
+    {
+        bench_component_type_t *t = ctx->types + i;
+        if (t->i.destroy)
+            t->i.destroy(t->i.manager);
+        free(t->data);
+        free(t->has);
+    }
+    free(ctx);
+}
+
+static inline bench_component_type_t *bench__type(tm_entity_context_o *ctx, tm_component_type_t type)
+{
+    return type.index < ctx->num_types ? ctx->types + type.index : 0;
+}
+
+static inline void bench_entity__create_child_allocator(tm_entity_context_o *ctx, const char *name, tm_allocator_i *a)
+{
+    *a = *bench_allocator();
+}
+
+static inline void bench_entity__destroy_child_allocator(tm_entity_context_o *ctx, tm_allocator_i *a)
+{
+}
+
+static inline tm_component_type_t bench_entity__register_component(tm_entity_context_o *ctx, const tm_component_i *com)
+{
+    const uint32_t idx = ctx->num_types++;
+    bench_component_type_t *t = ctx->types + idx;
+    *t = (bench_component_type_t){
+        .i = *com,
+        .name_hash = tm_murmur_hash_string(com->name),
+        .data = calloc(ctx->capacity, com->bytes),
+        .has = calloc(ctx->capacity, sizeof(bool)),
+    };
+    return (tm_component_type_t){.index = idx};
+}
+
+static inline tm_component_type_t bench_entity__lookup_component_type(tm_entity_context_o *ctx, tm_strhash_t name_hash)
+{
+    for (uint32_t i = 0; i < ctx->num_types; ++i)
+    {
+        if (ctx->types[i].name_hash == TM_STRHASH_U64(name_hash))
+            return (tm_component_type_t){.index = i};
+    }
+    return (tm_component_type_t){.index = UINT32_MAX};
+}
+
+static inline tm_component_manager_o *bench_entity__component_manager(tm_entity_context_o *ctx, tm_component_type_t type)
+{
+    const bench_component_type_t *t = bench__type(ctx, type);
+    return t ? t->i.manager : 0;
+}
+
+static inline void bench_entity__register_engine(tm_entity_context_o *ctx, const tm_engine_i *engine)
+{
+    if (ctx->num_engines < BENCH_MAX_ENGINES)
+        ctx->engines[ctx->num_engines++] = *engine;
+}
+
+static inline bool bench_entity__is_alive(tm_entity_context_o *ctx, tm_entity_t e)
+{
+    return e.u64 && e.u64 < ctx->num_entities;
+}
+
+static inline void *bench_entity__write_component(tm_entity_context_o *ctx, tm_entity_t e, tm_component_type_t type)
+{
+    bench_component_type_t *t = bench__type(ctx, type);
+    if (!t || !bench_entity__is_alive(ctx, e) || !t->has[e.u64])
+        return 0;
+    return t->data + e.u64 * t->i.bytes;
+}
+
+static inline const void *bench_entity__read_component(tm_entity_context_o *ctx, tm_entity_t e, tm_component_type_t type)
+{
+    return bench_entity__write_component(ctx, e, type);
+}
+
+static inline void bench_entity__notify(tm_entity_context_o *ctx, tm_component_type_t type, const tm_entity_t *entities, uint32_t num_entities)
+{
+    ++ctx->num_notify_calls;
+    ctx->num_notified += num_entities;
+}
+
+static inline struct tm_entity_api *bench_entity_api(void)
+{
+    static struct tm_entity_api api = {
+        .create_child_allocator = bench_entity__create_child_allocator,
+        .destroy_child_allocator = bench_entity__destroy_child_allocator,
+        .register_component = bench_entity__register_component,
+        .lookup_component_type = bench_entity__lookup_component_type,
+        .component_manager = bench_entity__component_manager,
+        .register_engine = bench_entity__register_engine,
+        .is_alive = bench_entity__is_alive,
+        .read_component = bench_entity__read_component,
+        .write_component = bench_entity__write_component,
+        .notify = bench_entity__notify,
+    };
+    return &api;
+}
+
+// Registers a component that has no manager, such as the transform component, whose data the benchmark
+// writes itself.
+static inline tm_component_type_t bench_entity_register_plain_component(tm_entity_context_o *ctx, const char *name, uint32_t bytes)
+{
+    return bench_entity__register_component(ctx, &(tm_component_i){.name = name, .bytes = bytes});
+}
+
+// Creates an entity without components.
+static inline tm_entity_t bench_entity_create(tm_entity_context_o *ctx)
+{
+    if (ctx->num_entities == ctx->capacity)
+    {
+        fprintf(stderr, "Bench entity context is full (%u entities).\n", ctx->capacity - 1);
+        exit(1);
+    }
+    return (tm_entity_t){.u64 = ctx->num_entities++};
+}
+
+// Adds component `type` to `e` and returns its zero-initialized data.
+static inline void *bench_entity_add_component(tm_entity_context_o *ctx, tm_entity_t e, tm_component_type_t type)
+{
+    bench_component_type_t *t = bench__type(ctx, type);
+    t->has[e.u64] = true;
+    return t->data + e.u64 * t->i.bytes;
+}
+
+// Calls `components_created()` of all component managers, as the entity context does once the entities of
+// a level have been created.
+static inline void bench_entity_components_created(tm_entity_context_o *ctx)
+{
+    for (uint32_t i = 0; i < ctx->num_types; ++i)
+    {
+        if (ctx->types[i].i.components_created)
+            ctx->types[i].i.components_created(ctx->types[i].i.manager);
+    }
+}
+
+// Builds the update set of `engine` for the `n` entities starting at `first`. The entities must have all
+// the components of the engine, which then lie next to each other in the component arrays, so they make up
+// a single update array. Free the result with `free()`.
+static inline tm_engine_update_set_t *bench_engine_update_set(tm_entity_context_o *ctx, const tm_engine_i *engine, tm_entity_t first, uint32_t n, const tm_entity_blackboard_value_t *blackboard, uint32_t num_blackboard_values)
+{
+    tm_engine_update_set_t *set = calloc(1, sizeof(tm_engine_update_set_t) + sizeof(tm_engine_update_array_t));
+    set->engine = engine;
+    set->blackboard_start = blackboard;
+    set->blackboard_end = blackboard + num_blackboard_values;
+    set->num_arrays = 1;
+
+    tm_entity_t *entities = malloc(n * sizeof(tm_entity_t));
+    for (uint32_t i = 0; i < n; ++i)
+        entities[i] = (tm_entity_t){.u64 = first.u64 + i};
+
+    tm_engine_update_array_t *a = set->arrays;
+    a->n = n;
+    a->entities = entities;
+    for (uint32_t k = 0; k < engine->num_components; ++k)
+    {
+        const bench_component_type_t *t = bench__type(ctx, engine->components[k]);
+        a->components[k] = t->data + first.u64 * t->i.bytes;
+    }
+    return set;
+}
+
+static inline void bench_engine_update_set_free(tm_engine_update_set_t *set)
+{
+    free((void *)set->arrays[0].entities);
+    free(set);
+}
+
+// ---
+// Statistics
+
+// Summary of a series of per-frame measurements.
+typedef struct bench_summary_t
+{
+    double mean;
+    double median;
+    double p99;
+    double max;
+} bench_summary_t;
+
+static inline int bench__compare_doubles(const void *a, const void *b)
+{
+    const double x = *(const double *)a;
+    const double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Summarizes the `n` `values`. Sorts `values` in place.
+static inline bench_summary_t bench_summarize(double *values, uint32_t n)
+{
+    if (!n)
+        return (bench_summary_t){0};
+
+    qsort(values, n, sizeof(*values), bench__compare_doubles);
+    double sum = 0;
+    for (uint32_t i = 0; i < n; ++i)
+        sum += values[i];
+
+    return (bench_summary_t){
+        .mean = sum / n,
+        .median = values[n / 2],
+        .p99 = values[(uint32_t)((uint64_t)(n - 1) * 99 / 100)],
+        .max = values[n - 1],
+    };
+}
+
+// Summarizes the `n` `values`, which are in nanoseconds, and prints the summary in `unit` (one of "ns", "us"
+// and "ms") after `label`, without ending the line. Sorts `values` in place.
+static inline bench_summary_t bench_print_summary(const char *label, double *values, uint32_t n, const char *unit)
+{
+    const bench_summary_t s = bench_summarize(values, n);
+    const double scale = !strcmp(unit, "ms") ? 1e-6 : !strcmp(unit, "us") ? 1e-3 : 1;
+    printf("    %-28s mean %10.3f %s, median %10.3f %s, p99 %10.3f %s, max %10.3f %s", label, s.mean * scale, unit, s.median * scale, unit, s.p99 * scale, unit, s.max * scale, unit);
+    return s;
+}
+
+// ---
+// Command line
+
+// Command line option of a benchmark. An option sets either `flag`, or `value` to a number of at least
+// `min`, or `value` to the index of one of the `num_choices` `choices`.
+typedef struct bench_option_t
+{
+    const char *name;
+    bool *flag;
+    uint32_t *value;
+    uint32_t min;
+    uint32_t num_choices;
+    const char *const *choices;
+} bench_option_t;
+
+static inline void bench__print_usage(const char *program, const bench_option_t *options, uint32_t num_options)
+{
+    fprintf(stderr, "usage: %s", program);
+    for (uint32_t i = 0; i < num_options; ++i)
+    {
+        const bench_option_t *o = options + i;
+        fprintf(stderr, " [%s", o->name);
+        if (o->choices)
+        {
+            for (uint32_t c = 0; c < o->num_choices; ++c)
+                fprintf(stderr, "%c%s", c ? '|' : ' ', o->choices[c]);
+        }
+        else if (o->value && o->min > 1)
+            fprintf(stderr, " N>=%u", o->min);
+        else if (o->value)
+            fprintf(stderr, " N");
+        fprintf(stderr, "]");
+    }
+    fprintf(stderr, "\n");
+}
+
+// Parses `argv` into `options`. Prints the usage and returns false if an argument isn't one of the options
+// or has an invalid value.
+static inline bool bench_parse_args(int argc, char **argv, const bench_option_t *options, uint32_t num_options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const bench_option_t *o = options;
+        while (o != options + num_options && strcmp(argv[i], o->name))
+            ++o;
+
+        bool ok = o != options + num_options;
+        if (ok && o->flag)
+            *o->flag = true;
+        else if (ok)
+        {
+            ok = i + 1 < argc;
+            if (ok && o->choices)
+            {
+                ++i;
+                uint32_t c = 0;
+                while (c < o->num_choices && strcmp(argv[i], o->choices[c]))
+                    ++c;
+                ok = c < o->num_choices;
+                *o->value = c;
+            }
+            else if (ok)
+            {
+                *o->value = (uint32_t)strtoul(argv[++i], 0, 10);
+                ok = *o->value >= o->min;
+            }
+        }
+
+        if (!ok)
+        {
+            bench__print_usage(argv[0], options, num_options);
+            return false;
+        }
+    }
+    return true;
+}
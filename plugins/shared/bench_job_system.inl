@@ -0,0 +1,165 @@
+// Stand-in for `tm_job_system_api`, returned by `bench_job_system_api()`, for the benchmark targets that
+// measure how engines scale over worker threads. `bench_job_system_init()` starts a pool of worker threads.
+// `run_jobs()` puts the jobs in a queue that the workers take them from, and `wait_for_counter_and_free()`
+// runs queued jobs on the calling thread until the counter reaches zero, so `bench_job_system_init(1)` runs
+// everything on the calling thread.
+//
+// Jobs can't wait for other jobs and can't be pinned to threads, which the benchmarked engines don't need.
+//
+// The including file must include `foundation/job_system.h` and `foundation/math.inl` before including this
+// file and link with pthreads.
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Largest number of threads, counting the thread that waits for the jobs.
+#define BENCH_MAX_THREADS 64u
+
+struct tm_atomic_counter_o
+{
+    uint32_t remaining;
+};
+
+typedef struct bench_job_t
+{
+    tm_jobdecl_t decl;
+    struct tm_atomic_counter_o *counter;
+} bench_job_t;
+
+typedef struct bench_job_system_t
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t has_jobs;
+
+    // Queued jobs are `jobs[first_job]` to `jobs[num_jobs - 1]`.
+    bench_job_t *jobs;
+    uint32_t first_job;
+    uint32_t num_jobs;
+    uint32_t capacity;
+
+    uint32_t num_workers;
+    pthread_t workers[BENCH_MAX_THREADS];
+
+    bool quit;
+    TM_PAD(7);
+} bench_job_system_t;
+
+static bench_job_system_t bench_job_system;
+
+// Pops a job from the queue. Must be called with the mutex locked.
+static inline bool bench_job_system__pop(bench_job_t *job)
+{
+    bench_job_system_t *js = &bench_job_system;
+    if (js->first_job == js->num_jobs)
+        return false;
+
+    *job = js->jobs[js->first_job++];
+    if (js->first_job == js->num_jobs)
+        js->first_job = js->num_jobs = 0;
+    return true;
+}
+
+static inline void bench_job_system__run(const bench_job_t *job)
+{
+    job->decl.task(job->decl.data);
+    __atomic_sub_fetch(&job->counter->remaining, 1, __ATOMIC_ACQ_REL);
+}
+
+static inline void *bench_job_system__worker(void *arg)
+{
+    bench_job_system_t *js = &bench_job_system;
+    while (true)
+    {
+        bench_job_t job;
+        pthread_mutex_lock(&js->mutex);
+        while (!js->quit && !bench_job_system__pop(&job))
+            pthread_cond_wait(&js->has_jobs, &js->mutex);
+        const bool quit = js->quit;
+        pthread_mutex_unlock(&js->mutex);
+
+        if (quit)
+            return 0;
+        bench_job_system__run(&job);
+    }
+}
+
+static inline struct tm_atomic_counter_o *bench_job_system__run_jobs(const tm_jobdecl_t *jobs, uint32_t num_jobs)
+{
+    bench_job_system_t *js = &bench_job_system;
+    struct tm_atomic_counter_o *counter = malloc(sizeof(*counter));
+    counter->remaining = num_jobs;
+
+    pthread_mutex_lock(&js->mutex);
+    if (js->num_jobs + num_jobs > js->capacity)
+    {
+        js->capacity = tm_max(js->capacity * 2, js->num_jobs + num_jobs);
+        js->jobs = realloc(js->jobs, js->capacity * sizeof(*js->jobs));
+    }
+    for (uint32_t i = 0; i < num_jobs; ++i)
+        js->jobs[js->num_jobs++] = (bench_job_t){.decl = jobs[i], .counter = counter};
+    pthread_cond_broadcast(&js->has_jobs);
+    pthread_mutex_unlock(&js->mutex);
+    return counter;
+}
+
+static inline void bench_job_system__wait_for_counter_and_free(struct tm_atomic_counter_o *counter)
+{
+    bench_job_system_t *js = &bench_job_system;
+    while (__atomic_load_n(&counter->remaining, __ATOMIC_ACQUIRE))
+    {
+        bench_job_t job;
+        pthread_mutex_lock(&js->mutex);
+        const bool has_job = bench_job_system__pop(&job);
+        pthread_mutex_unlock(&js->mutex);
+
+        if (has_job)
+            bench_job_system__run(&job);
+        else
+            sched_yield();
+    }
+    free(counter);
+}
+
+static inline struct tm_job_system_api *bench_job_system_api(void)
+{
+    static struct tm_job_system_api api = {
+        .run_jobs = bench_job_system__run_jobs,
+        .wait_for_counter_and_free = bench_job_system__wait_for_counter_and_free,
+    };
+    return &api;
+}
+
+// Starts `num_threads - 1` worker threads. The thread that waits for jobs is the last one.
+static inline void bench_job_system_init(uint32_t num_threads)
+{
+    bench_job_system_t *js = &bench_job_system;
+    *js = (bench_job_system_t){.num_workers = tm_min(tm_max(num_threads, 1u), BENCH_MAX_THREADS) - 1};
+    pthread_mutex_init(&js->mutex, 0);
+    pthread_cond_init(&js->has_jobs, 0);
+    for (uint32_t i = 0; i < js->num_workers; ++i)
+    {
+        if (pthread_create(js->workers + i, 0, bench_job_system__worker, 0))
+        {
+            fprintf(stderr, "Failed to start bench worker thread %u.\n", i);
+            exit(1);
+        }
+    }
+}
+
+static inline void bench_job_system_shutdown(void)
+{
+    bench_job_system_t *js = &bench_job_system;
+    pthread_mutex_lock(&js->mutex);
+    js->quit = true;
+    pthread_cond_broadcast(&js->has_jobs);
+    pthread_mutex_unlock(&js->mutex);
+
+    for (uint32_t i = 0; i < js->num_workers; ++i)
+        pthread_join(js->workers[i], 0);
+    pthread_cond_destroy(&js->has_jobs);
+    pthread_mutex_destroy(&js->mutex);
+    free(js->jobs);
+    *js = (bench_job_system_t){0};
+}
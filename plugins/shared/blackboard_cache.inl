@@ -0,0 +1,77 @@
+// Reads values from the blackboard of an engine update without scanning the whole blackboard for every
+// value. The keys an engine reads are given once, when the engine is registered. The first update finds the
+// index of each key in the blackboard and remembers it. Later updates check that the key is still at that
+// index, which it is unless values have been added to or removed from the blackboard, and only scan again
+// if it has moved.
+//
+// A cache belongs to one engine and is updated by its update function, so it must not be shared between
+// engines that can run at the same time.
+//
+// The including file must include `plugins/entity/entity.h` and `foundation/math.inl` before including this
+// file.
+
+// Maximum number of keys in a `blackboard_cache_t`.
+#define BLACKBOARD_CACHE_MAX_KEYS 8
+
+typedef struct blackboard_cache_t
+{
+    tm_strhash_t keys[BLACKBOARD_CACHE_MAX_KEYS];
+
+    // Index in the blackboard where each key was last found, or UINT32_MAX if it wasn't.
+    uint32_t slots[BLACKBOARD_CACHE_MAX_KEYS];
+
+    uint32_t num_keys;
+
+    // Number of times a key was not at its remembered index and the blackboard was scanned.
+    uint32_t num_scans;
+} blackboard_cache_t;
+
+// Sets up the cache to look up the `n` `keys`. Values are then read by their index in `keys`.
+static inline void blackboard_cache_init(blackboard_cache_t *c, const tm_strhash_t *keys, uint32_t n)
+{
+    *c = (blackboard_cache_t){.num_keys = tm_min(n, BLACKBOARD_CACHE_MAX_KEYS)};
+    for (uint32_t i = 0; i < c->num_keys; ++i)
+    {
+        c->keys[i] = keys[i];
+        c->slots[i] = UINT32_MAX;
+    }
+}
+
+// Returns the blackboard value of key `k` in `data`, or NULL if the blackboard doesn't have it.
+static inline const tm_entity_blackboard_value_t *blackboard_cache_get(blackboard_cache_t *c, const tm_engine_update_set_t *data, uint32_t k)
+{
+    const tm_entity_blackboard_value_t *bb = data->blackboard_start;
+    const uint32_t num_values = (uint32_t)(data->blackboard_end - data->blackboard_start);
+    const uint64_t key = TM_STRHASH_U64(c->keys[k]);
+
+    const uint32_t slot = c->slots[k];
+    if (slot < num_values && TM_STRHASH_U64(bb[slot].id) == key)
+        return bb + slot;
+
+    ++c->num_scans;
+    for (uint32_t i = 0; i < num_values; ++i)
+    {
+        if (TM_STRHASH_U64(bb[i].id) == key)
+        {
+            c->slots[k] = i;
+            return bb + i;
+        }
+    }
+
+    c->slots[k] = UINT32_MAX;
+    return 0;
+}
+
+// Returns the double value of key `k`, or `def` if the blackboard doesn't have it.
+static inline double blackboard_cache_double(blackboard_cache_t *c, const tm_engine_update_set_t *data, uint32_t k, double def)
+{
+    const tm_entity_blackboard_value_t *v = blackboard_cache_get(c, data, k);
+    return v ? v->double_value : def;
+}
+
+// Returns the pointer value of key `k`, or NULL if the blackboard doesn't have it.
+static inline void *blackboard_cache_ptr(blackboard_cache_t *c, const tm_engine_update_set_t *data, uint32_t k)
+{
+    const tm_entity_blackboard_value_t *v = blackboard_cache_get(c, data, k);
+    return v ? v->ptr_value : 0;
+}